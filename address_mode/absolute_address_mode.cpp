@@ -81,6 +81,12 @@ enum PeNESStatus AbsoluteXIndexedAddressMode::get_storage(
 
     hardware_address += register_index;
 
+    /* Reads through an indexed address take an extra cycle when the index carries into the high byte. */
+    program_ctx->did_cross_page = (
+        MEMORY_MAP_ADDRESS_TO_PAGE(hardware_address) !=
+        MEMORY_MAP_ADDRESS_TO_PAGE(system_native_to_host_endianness(absolute_address))
+    );
+
     /* Retrieve storage at absolute indexed address. */
     status = program_ctx->memory_map.get_memory_storage(
         hardware_address,
@@ -125,6 +131,11 @@ enum PeNESStatus AbsoluteYIndexedAddressMode::get_storage(
 
     converted_address += register_data;
 
+    program_ctx->did_cross_page = (
+        MEMORY_MAP_ADDRESS_TO_PAGE(converted_address) !=
+        MEMORY_MAP_ADDRESS_TO_PAGE(system_native_to_host_endianness(absolute_address))
+    );
+
     /* Retrieve storage at absolute indexed address. */
     status = program_ctx->memory_map.get_memory_storage(
         converted_address,
@@ -22,18 +22,18 @@ using namespace address_mode;
 /** Static Variables ******************************************************/
 const utils::InstanceFactoryList<enum AddressModeType, IAddressMode> AddressModeTable::address_mode_instance_factory_list = {
     nullptr,
-    utils::SubClassFactory<IAddressMode>::create_instance<ImpliedAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<AccumulatorAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<AbsoluteAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<AbsoluteXIndexedAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<AbsoluteYIndexedAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<ImmediateSingleAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<ImmediateDoubleAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<RelativeAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<IndirectAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<XIndexedIndirectAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<IndirectYIndexedAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<ZeropageAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<ZeropageXIndexedAddressMode>,
-    utils::SubClassFactory<IAddressMode>::create_instance<ZeropageYIndexedAddressMode>
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ImpliedAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<AccumulatorAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<AbsoluteAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<AbsoluteXIndexedAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<AbsoluteYIndexedAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ImmediateSingleAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ImmediateDoubleAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<RelativeAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<IndirectAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<XIndexedIndirectAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<IndirectYIndexedAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ZeropageAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ZeropageXIndexedAddressMode>,
+    utils::SubClassFactory<IAddressMode>::get_shared_instance<ZeropageYIndexedAddressMode>
 };
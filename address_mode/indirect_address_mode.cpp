@@ -216,6 +216,12 @@ enum PeNESStatus IndirectYIndexedAddressMode::get_storage(
      * */
     indexed_direct_address = system_native_to_host_endianness(direct_address) + register_index;
 
+    /* Reads through an indexed address take an extra cycle when the index carries into the high byte. */
+    program_ctx->did_cross_page = (
+        MEMORY_MAP_ADDRESS_TO_PAGE(indexed_direct_address) !=
+        MEMORY_MAP_ADDRESS_TO_PAGE(system_native_to_host_endianness(direct_address))
+    );
+
     /* Retrieve data at absolute indexed direct address. */
     status = program_ctx->memory_map.get_memory_storage(
         indexed_direct_address,
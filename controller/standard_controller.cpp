@@ -0,0 +1,63 @@
+/**
+ * @brief  The standard NES controllers, read through the serial ports at $4016 and $4017.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "controller/standard_controller.h"
+
+/** Functions *************************************************************/
+enum PeNESStatus StandardController::read_register(native_address_t register_address, native_word_t *output_data)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t port_index = 0;
+
+    ASSERT(nullptr != output_data);
+
+    if ((STANDARD_CONTROLLER_PORT_1_ADDRESS != register_address) &&
+        (STANDARD_CONTROLLER_PORT_2_ADDRESS != register_address)) {
+        *output_data = 0;
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    port_index = register_address - STANDARD_CONTROLLER_PORT_1_ADDRESS;
+
+    *output_data = STANDARD_CONTROLLER_OPEN_BUS_DATA | (this->shift_registers[port_index] & STANDARD_CONTROLLER_DATA_MASK);
+
+    /* While the strobe is set, the shift register keeps reloading, and so every read returns the A button. */
+    if (false == this->is_strobe_set) {
+        this->shift_registers[port_index] = (this->shift_registers[port_index] >> 1) | STANDARD_CONTROLLER_SHIFT_REGISTER_FILL;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus StandardController::write_register(native_address_t register_address, native_word_t data)
+{
+    std::size_t port_index = 0;
+
+    /* $4017 is the APU frame counter when written, and so only $4016 controls the controllers. */
+    if (STANDARD_CONTROLLER_PORT_1_ADDRESS != register_address) {
+        return PENES_STATUS_SUCCESS;
+    }
+
+    this->is_strobe_set = (0 != (data & STANDARD_CONTROLLER_STROBE_MASK));
+
+    /* Both controllers are latched by the same strobe. */
+    for (port_index = 0; port_index < STANDARD_CONTROLLER_NUM_PORTS; port_index++) {
+        this->shift_registers[port_index] = STANDARD_CONTROLLER_SHIFT_REGISTER_FILL | this->buttons[port_index];
+    }
+
+    return PENES_STATUS_SUCCESS;
+}
@@ -0,0 +1,86 @@
+/**
+ * @brief  The standard NES controllers, read through the serial ports at $4016 and $4017.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __STANDARD_CONTROLLER_H__
+#define __STANDARD_CONTROLLER_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "peripheral/peripheral_interface.h"
+
+/** Constants *************************************************************/
+#define STANDARD_CONTROLLER_NUM_PORTS (2)
+#define STANDARD_CONTROLLER_PORT_1_ADDRESS (0x4016)
+#define STANDARD_CONTROLLER_PORT_2_ADDRESS (0x4017)
+#define STANDARD_CONTROLLER_STROBE_MASK (0x01)
+#define STANDARD_CONTROLLER_DATA_MASK (0x01)
+/* The upper bits of a port read are not driven, and keep the high byte of the address on the bus. */
+#define STANDARD_CONTROLLER_OPEN_BUS_DATA (0x40)
+/* Once all 8 buttons are shifted out, an official controller keeps returning 1. */
+#define STANDARD_CONTROLLER_SHIFT_REGISTER_FILL (0xFF00)
+
+/** Enums *****************************************************************/
+/** @brief The buttons of a controller, in the order they are shifted out. */
+enum StandardControllerButton {
+    STANDARD_CONTROLLER_BUTTON_NONE = 0,
+    STANDARD_CONTROLLER_BUTTON_A = 1 << 0,
+    STANDARD_CONTROLLER_BUTTON_B = 1 << 1,
+    STANDARD_CONTROLLER_BUTTON_SELECT = 1 << 2,
+    STANDARD_CONTROLLER_BUTTON_START = 1 << 3,
+    STANDARD_CONTROLLER_BUTTON_UP = 1 << 4,
+    STANDARD_CONTROLLER_BUTTON_DOWN = 1 << 5,
+    STANDARD_CONTROLLER_BUTTON_LEFT = 1 << 6,
+    STANDARD_CONTROLLER_BUTTON_RIGHT = 1 << 7
+};
+
+/** Classes ***************************************************************/
+/** @brief The controllers plugged into both ports, attached to the second I/O register region.
+ *         Writing 1 and then 0 to the strobe bit of $4016 latches the buttons of both controllers,
+ *         which are then read a bit at a time, from A to Right, through each port.
+ *         The other registers of the region read as 0, since the APU is not emulated.
+ * */
+class StandardController : public IPeripheral {
+public:
+    /** @brief          Set the buttons held on a controller, to be latched by the next strobe.
+     *
+     *  @param[in]      port_index                  The index of the port the controller is plugged into.
+     *  @param[in]      buttons                     A mask of StandardControllerButton values.
+     * */
+    inline void set_buttons(std::size_t port_index, native_word_t buttons)
+    {
+        ASSERT(STANDARD_CONTROLLER_NUM_PORTS > port_index);
+
+        this->buttons[port_index] = buttons;
+        if (true == this->is_strobe_set) {
+            this->shift_registers[port_index] = STANDARD_CONTROLLER_SHIFT_REGISTER_FILL | buttons;
+        }
+    }
+
+    enum PeNESStatus read_register(native_address_t register_address, native_word_t *output_data) override;
+
+    enum PeNESStatus write_register(native_address_t register_address, native_word_t data) override;
+
+protected:
+    /** @brief The controllers have no timing of their own. */
+    inline enum PeNESStatus run_cycles(std::uint64_t num_cycles) override
+    {
+        return PENES_STATUS_SUCCESS;
+    }
+
+private:
+    std::array<native_word_t, STANDARD_CONTROLLER_NUM_PORTS> buttons = {};
+    std::array<std::uint16_t, STANDARD_CONTROLLER_NUM_PORTS> shift_registers = {};
+    bool is_strobe_set = false;
+};
+
+#endif /* __STANDARD_CONTROLLER_H__ */
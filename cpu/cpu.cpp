@@ -5,8 +5,10 @@
  * */
 
 /** Headers ***************************************************************/
-#include <sys/time.h>
-#include <iostream>
+#include <cerrno>
+#include <cmath>
+#include <ostream>
+#include <time.h>
 
 #include "cpu/cpu.h"
 
@@ -15,15 +17,72 @@
 /** Enums *****************************************************************/
 /** Typedefs **************************************************************/
 /** Structs ***************************************************************/
+/** Static Variables ******************************************************/
+/* Rows are indexed by the high nibble of the opcode, and columns by the low nibble.
+ * Unofficial opcodes are included as well, although the decoder does not support them yet.
+ * */
+const std::array<std::uint8_t, CPU_NUM_OPCODES> CPU::instruction_cycles = {
+    7, 6, 2, 8, 3, 3, 5, 5, 3, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 2, 8, 3, 3, 5, 5, 4, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 2, 8, 3, 3, 5, 5, 3, 2, 2, 2, 3, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    6, 6, 2, 8, 3, 3, 5, 5, 4, 2, 2, 2, 5, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 2, 4, 4, 4, 4,
+    2, 6, 2, 6, 4, 4, 4, 4, 2, 5, 2, 5, 5, 5, 5, 5,
+    2, 6, 2, 6, 3, 3, 3, 3, 2, 2, 2, 2, 4, 4, 4, 4,
+    2, 5, 2, 5, 4, 4, 4, 4, 2, 4, 2, 4, 4, 4, 4, 4,
+    2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7,
+    2, 6, 2, 8, 3, 3, 5, 5, 2, 2, 2, 2, 4, 4, 6, 6,
+    2, 5, 2, 8, 4, 4, 6, 6, 2, 4, 2, 7, 4, 4, 7, 7
+};
+
+/* Branches are not included, since their penalty depends on whether they are taken, see IBranchOpcode. */
+const std::array<std::uint8_t, CPU_NUM_OPCODES> CPU::instruction_page_cross_cycles = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1, 1, 1,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 1, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0
+};
+
+const std::array<const char *, CPU_PACING_MODE_NUM_PACING_MODES> CPU::pacing_mode_names = {
+    "unthrottled",
+    "real_time",
+    "multiplier"
+};
+
 /** Functions *************************************************************/
-enum PeNESStatus CPU::run()
+enum PeNESStatus CPU::run(std::size_t num_frames, struct CPUPerformanceReport *output_report)
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    instruction_set::Instruction *current_instruction = nullptr;
-
-    struct timeval start_time = {0};
-    struct timeval end_time = {0};
-    std::size_t total_instructions = 0;
+    std::size_t frame_index = 0;
+    std::uint64_t start_time_ns = 0;
+    std::uint64_t current_time_ns = 0;
+    std::uint64_t previous_frame_end_ns = 0;
+    std::uint64_t deadline_ns = 0;
+    std::uint64_t frame_period_ns = 0;
+    double frame_seconds = 0;
+    double sum_frame_seconds = 0;
+    double sum_squared_frame_seconds = 0;
+    std::uint64_t start_num_instructions = 0;
+    std::uint64_t start_num_cycles = 0;
+    std::uint64_t start_num_frames = 0;
+    struct CPUPerformanceReport report;
 
     /* Since the program is starting up, reset the machine by jumping to the address at the reset interrupt vector. */
     status = this->reset();
@@ -32,41 +91,245 @@ enum PeNESStatus CPU::run()
         goto l_cleanup;
     }
 
-    gettimeofday(&start_time, NULL);
+    /* Measure with a monotonic clock, so that adjustments of the wall clock cannot skew the report or the pacing. */
+    status = CPU::get_monotonic_time(&start_time_ns);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    start_num_instructions = this->get_num_instructions();
+    start_num_cycles = this->get_num_cycles();
+    start_num_frames = this->get_num_frames();
+    previous_frame_end_ns = start_time_ns;
+    deadline_ns = start_time_ns;
+    if (CPU_PACING_MODE_UNTHROTTLED != this->pacing_mode) {
+        frame_period_ns = static_cast<std::uint64_t>(
+            CPU_NANOSECONDS_PER_SECOND / (CPU_NTSC_FRAME_RATE_HZ * this->speed_multiplier)
+        );
+    }
 
+    report.pacing_mode = this->pacing_mode;
+    report.speed_multiplier = this->speed_multiplier;
 
-    while (total_instructions < 20000) {
-        /* Retrieve next instruction. */
-        status = this->instruction_decoder.next_instruction(&current_instruction);
+    for (frame_index = 0; frame_index < num_frames; frame_index++) {
+        status = this->step_frame();
         if (PENES_STATUS_SUCCESS != status) {
-            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("next_instruction failed. Status: %d.\n", status);
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("step_frame failed. Status: %d.\n", status);
             goto l_cleanup;
         }
 
-        /* Execute the instruction. */
-        status = current_instruction->exec();
+        status = CPU::get_monotonic_time(&current_time_ns);
         if (PENES_STATUS_SUCCESS != status) {
-            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("exec failed. Status: %d.\n", status);
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
             goto l_cleanup;
         }
 
-        /* TODO CPU cycle bookkeeping. */
+        /* Deadlines are kept on an absolute schedule, so that the wakeup error of one frame does not drift the next.
+         * A late frame restarts the schedule from itself, rather than rushing through the following frames.
+         * */
+        if (CPU_PACING_MODE_UNTHROTTLED != this->pacing_mode) {
+            deadline_ns += frame_period_ns;
+            if (current_time_ns > deadline_ns) {
+                report.num_late_frames++;
+                deadline_ns = current_time_ns;
+            } else {
+                status = CPU::wait_until(deadline_ns, &current_time_ns);
+                if (PENES_STATUS_SUCCESS != status) {
+                    DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("wait_until failed. Status: %d.\n", status);
+                    goto l_cleanup;
+                }
+            }
+        }
+
+        frame_seconds = static_cast<double>(current_time_ns - previous_frame_end_ns) / CPU_NANOSECONDS_PER_SECOND;
+        previous_frame_end_ns = current_time_ns;
+
+        report.min_frame_seconds = (0 == frame_index)? frame_seconds: MIN(report.min_frame_seconds, frame_seconds);
+        report.max_frame_seconds = MAX(report.max_frame_seconds, frame_seconds);
+        sum_frame_seconds += frame_seconds;
+        sum_squared_frame_seconds += frame_seconds * frame_seconds;
+    }
+
+    if (nullptr != output_report) {
+        /* Reset has its own cycles, which are left out of the measured interval along with its time. */
+        report.num_instructions = this->get_num_instructions() - start_num_instructions;
+        report.num_cycles = this->get_num_cycles() - start_num_cycles;
+        report.num_frames = this->get_num_frames() - start_num_frames;
+        report.elapsed_seconds = static_cast<double>(previous_frame_end_ns - start_time_ns) / CPU_NANOSECONDS_PER_SECOND;
 
-        /* Check for interrupts and service if necessary. */
-        status = service_interrupts();
+        if (0 < report.elapsed_seconds) {
+            report.instructions_per_second = report.num_instructions / report.elapsed_seconds;
+            report.cycles_per_second = report.num_cycles / report.elapsed_seconds;
+            report.frames_per_second = report.num_frames / report.elapsed_seconds;
+            report.speed_ratio = report.cycles_per_second / CPU_NTSC_CLOCK_RATE_HZ;
+        }
+
+        if (0 < num_frames) {
+            report.mean_frame_seconds = sum_frame_seconds / num_frames;
+            report.frame_jitter_seconds = std::sqrt(MAX(
+                0.0,
+                sum_squared_frame_seconds / num_frames - report.mean_frame_seconds * report.mean_frame_seconds
+            ));
+        }
+
+        *output_report = report;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void CPU::write_performance_report(
+    const struct CPUPerformanceReport& report,
+    std::ostream& output_stream,
+    bool is_json
+)
+{
+    ASSERT((CPU_PACING_MODE_NONE < report.pacing_mode) && (CPU_PACING_MODE_NUM_PACING_MODES > report.pacing_mode));
+
+    if (true == is_json) {
+        output_stream << "{\"instructions\": " << report.num_instructions
+                      << ", \"cycles\": " << report.num_cycles
+                      << ", \"frames\": " << report.num_frames
+                      << ", \"elapsed_seconds\": " << report.elapsed_seconds
+                      << ", \"instructions_per_second\": " << report.instructions_per_second
+                      << ", \"cycles_per_second\": " << report.cycles_per_second
+                      << ", \"frames_per_second\": " << report.frames_per_second
+                      << ", \"speed_ratio\": " << report.speed_ratio
+                      << ", \"pacing\": {\"mode\": \"" << CPU::pacing_mode_names[report.pacing_mode] << '"'
+                      << ", \"speed_multiplier\": " << report.speed_multiplier << '}'
+                      << ", \"frame_time\": {\"min_seconds\": " << report.min_frame_seconds
+                      << ", \"mean_seconds\": " << report.mean_frame_seconds
+                      << ", \"max_seconds\": " << report.max_frame_seconds
+                      << ", \"jitter_seconds\": " << report.frame_jitter_seconds
+                      << ", \"late_frames\": " << report.num_late_frames << "}}" << std::endl;
+        return;
+    }
+
+    output_stream << "Instructions: " << report.num_instructions << std::endl
+                  << "CPU cycles: " << report.num_cycles << std::endl
+                  << "Frames: " << report.num_frames << std::endl
+                  << "Elapsed time (s): " << report.elapsed_seconds << std::endl
+                  << "Instructions per second: " << report.instructions_per_second << std::endl
+                  << "Cycles per second: " << report.cycles_per_second << std::endl
+                  << "Frames per second: " << report.frames_per_second << std::endl
+                  << "Speed relative to NTSC hardware: " << report.speed_ratio << 'x' << std::endl
+                  << "Pacing: " << CPU::pacing_mode_names[report.pacing_mode]
+                  << " (" << report.speed_multiplier << "x)" << std::endl
+                  << "Frame time (s): min " << report.min_frame_seconds
+                  << ", mean " << report.mean_frame_seconds
+                  << ", max " << report.max_frame_seconds
+                  << ", jitter " << report.frame_jitter_seconds << std::endl
+                  << "Late frames: " << report.num_late_frames << std::endl;
+}
+
+
+enum PeNESStatus CPU::get_monotonic_time(std::uint64_t *output_time_ns)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct timespec current_time = {0};
+
+    ASSERT(nullptr != output_time_ns);
+
+    if (0 != clock_gettime(CLOCK_MONOTONIC, &current_time)) {
+        status = PENES_STATUS_CPU_GET_MONOTONIC_TIME_CLOCK_GETTIME_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("clock_gettime failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    *output_time_ns = static_cast<std::uint64_t>(current_time.tv_sec) * CPU_NANOSECONDS_PER_SECOND + current_time.tv_nsec;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus CPU::wait_until(std::uint64_t deadline_ns, std::uint64_t *output_time_ns)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint64_t current_time_ns = 0;
+    std::uint64_t wakeup_time_ns = 0;
+    struct timespec wakeup_time = {0};
+    int sleep_result = 0;
+
+    ASSERT(nullptr != output_time_ns);
+
+    status = CPU::get_monotonic_time(&current_time_ns);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Sleep through most of the wait. An absolute wakeup time keeps signal interruptions from extending the sleep. */
+    if (current_time_ns + CPU_PACING_SPIN_THRESHOLD_NS < deadline_ns) {
+        wakeup_time_ns = deadline_ns - CPU_PACING_SPIN_THRESHOLD_NS;
+        wakeup_time.tv_sec = wakeup_time_ns / CPU_NANOSECONDS_PER_SECOND;
+        wakeup_time.tv_nsec = wakeup_time_ns % CPU_NANOSECONDS_PER_SECOND;
+
+        do {
+            sleep_result = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup_time, nullptr);
+        } while (EINTR == sleep_result);
+
+        if (0 != sleep_result) {
+            status = PENES_STATUS_CPU_WAIT_UNTIL_CLOCK_NANOSLEEP_FAILED;
+            DEBUG_PRINT_WITH_ARGS("clock_nanosleep failed. Status: %d. Error: %d.\n", status, sleep_result);
+            goto l_cleanup;
+        }
+    }
+
+    /* Spin for the rest of the wait, which the sleep is too coarse for. */
+    do {
+        status = CPU::get_monotonic_time(&current_time_ns);
         if (PENES_STATUS_SUCCESS != status) {
-            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("service_interrupts failed. Status: %d.\n", status);
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
             goto l_cleanup;
         }
+    } while (current_time_ns < deadline_ns);
+
+    *output_time_ns = current_time_ns;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
 
-        /* Release resources used by the instruction. */
-        delete current_instruction;
 
-        total_instructions++;
+enum PeNESStatus CPU::run_until(std::uint64_t target_cycle)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint64_t next_deadline = 0;
+
+    /* Dispatch whatever became due since the last run, such as an interrupt raised in between. */
+    status = this->dispatch_events();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("dispatch_events failed. Status: %d.\n", status);
+        goto l_cleanup;
     }
 
-    gettimeofday(&end_time, NULL);
-    std::cout << "Average Instruction time (us): " << static_cast<double>(end_time.tv_usec - start_time.tv_usec) / total_instructions  << std::endl;
+    /* Instructions run uninterrupted until the earliest event is due, rather than polling for interrupts after each.
+     * Every instruction runs to completion, and so the boundary may be overshot by the last instruction.
+     * */
+    while (this->program_ctx->num_cycles < target_cycle) {
+        next_deadline = MIN(target_cycle, this->program_ctx->event_scheduler.get_next_deadline());
+
+        while (this->program_ctx->num_cycles < next_deadline) {
+            status = this->execute_instruction();
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("execute_instruction failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        }
+
+        status = this->dispatch_events();
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("dispatch_events failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
 
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
@@ -74,17 +337,55 @@ l_cleanup:
 }
 
 
-enum PeNESStatus CPU::reset()
+enum PeNESStatus CPU::step_frame()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    /* The frame end event is always pending once the machine has been reset, and is rescheduled as it is dispatched. */
+    status = this->run_until(this->program_ctx->event_scheduler.get_deadline(EVENT_SCHEDULER_EVENT_TYPE_FRAME_END));
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("run_until failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus CPU::step()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    status = this->execute_instruction();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("execute_instruction failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
 
+    status = this->dispatch_events();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("dispatch_events failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus CPU::reset()
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
     RegisterStorage<native_word_t> *register_status = nullptr;
     MemoryStorage *reset_jump_vector_storage = nullptr;
     native_word_t previous_status = 0;
 
-    /* Reset the interrupt receive flags. */
-    this->program_ctx->did_receive_irq = false;
-    this->program_ctx->did_receive_nmi = false;
+    /* Drop any pending interrupts. */
+    this->program_ctx->event_scheduler.clear();
+    this->program_ctx->is_irq_masked = false;
 
     /* Set the Interrupt Disable status flag. */
     register_status = this->program_ctx->register_file.get_register_status();
@@ -101,42 +402,123 @@ enum PeNESStatus CPU::reset()
         goto l_cleanup;
     }
 
+    /* The reset sequence takes as long as an interrupt, although nothing is pushed. */
+    this->program_ctx->num_cycles += CPU_RESET_CYCLES;
+
+    /* Frame boundaries stay at fixed cycles since power on, even across a reset. */
+    this->program_ctx->event_scheduler.schedule(
+        EVENT_SCHEDULER_EVENT_TYPE_FRAME_END,
+        CPU::get_frame_end_cycle(this->get_num_frames())
+    );
+
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
     return status;
 }
 
 
-enum PeNESStatus CPU::service_interrupts()
+enum PeNESStatus CPU::execute_instruction()
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    RegisterStorage<native_word_t> *register_status = nullptr;
-    MemoryStorage *jump_vector_storage = nullptr;
-    native_word_t program_status = 0;
-    bool did_set_interrupt_disable = false;
+    instruction_set::Instruction *current_instruction = nullptr;
 
-    /* Get the Interrupt Disable status flag. */
-    register_status = this->program_ctx->register_file.get_register_status();
-    program_status = register_status->read();
-    did_set_interrupt_disable = (0 != (program_status & REGISTER_STATUS_FLAG_MASK_INTERRUPT));
-
-    /* Check for NMI interrupts first (has higher priority). */
-    if (true == this->program_ctx->did_receive_nmi) {
-        /* Retrieve the NMI interrupt handler vector from the program context. */
-        jump_vector_storage = this->program_ctx->memory_map.get_nmi_jump_vector();
-        /* Reset NMI receive status because the NMIs are esge-triggered. */
-        this->program_ctx->did_receive_nmi = false;
-        /* Next, check for IRQ interrupts (in case they haven't been disabled). */
-    } else if ((true == did_set_interrupt_disable) &&
-               (true == this->program_ctx->did_receive_nmi)) {
-        /* Retrieve the IRQ interrupt handler vector from the program context. */
-        jump_vector_storage = this->program_ctx->memory_map.get_irq_jump_vector();
-        /* No condition is met, skip the rest. */
-    } else {
-        status = PENES_STATUS_SUCCESS;
+    /* Retrieve next instruction. */
+    status = this->instruction_decoder.next_instruction(&current_instruction);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("next_instruction failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Execute the instruction. */
+    status = current_instruction->exec();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("exec failed. Status: %d.\n", status);
         goto l_cleanup;
     }
 
+    /* Account for the cycles the instruction took, including its page crossing and branch penalties. */
+    this->account_instruction_cycles(current_instruction->get_opcode_data());
+    this->num_instructions++;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    /* Release resources used by the instruction. */
+    delete current_instruction;
+
+    return status;
+}
+
+
+enum PeNESStatus CPU::dispatch_events()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    EventScheduler *event_scheduler = &this->program_ctx->event_scheduler;
+    enum EventSchedulerEventType event_type = EVENT_SCHEDULER_EVENT_TYPE_NONE;
+    native_word_t program_status = 0;
+
+    while (true == event_scheduler->pop_due_event(this->program_ctx->num_cycles, &event_type)) {
+        /* Peripherals only run when they have to, and an event is one of those times,
+         * since it may depend on their state or they may have raised it.
+         * */
+        status = this->program_ctx->memory_map.sync_peripherals(this->program_ctx->num_cycles);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("sync_peripherals failed. Status: %d\n", status);
+            goto l_cleanup;
+        }
+
+        switch (event_type) {
+        case EVENT_SCHEDULER_EVENT_TYPE_NMI:
+            status = this->service_interrupt(this->program_ctx->memory_map.get_nmi_jump_vector());
+            break;
+
+        case EVENT_SCHEDULER_EVENT_TYPE_IRQ:
+            /* IRQs are level triggered, and so a masked IRQ is held, rather than polled for after every instruction,
+             * until an instruction clears the Interrupt Disable flag and schedules it again,
+             * see ProgramContext::release_masked_irq. A serviced IRQ is dropped,
+             * and a source whose line is still asserted after the handler acknowledges it must schedule it again.
+             * */
+            program_status = this->program_ctx->register_file.get_register_status()->read();
+            if (0 != (program_status & REGISTER_STATUS_FLAG_MASK_INTERRUPT)) {
+                this->program_ctx->is_irq_masked = true;
+                status = PENES_STATUS_SUCCESS;
+                break;
+            }
+
+            status = this->service_interrupt(this->program_ctx->memory_map.get_irq_jump_vector());
+            break;
+
+        case EVENT_SCHEDULER_EVENT_TYPE_FRAME_END:
+            event_scheduler->schedule(
+                EVENT_SCHEDULER_EVENT_TYPE_FRAME_END,
+                CPU::get_frame_end_cycle(this->get_num_frames())
+            );
+            status = PENES_STATUS_SUCCESS;
+            break;
+
+        default:
+            ASSERT(false);
+            status = PENES_STATUS_SUCCESS;
+            break;
+        }
+
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Failed to dispatch event. Status: %d. Event: %d\n", status, event_type);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus CPU::service_interrupt(MemoryStorage *jump_vector_storage)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != jump_vector_storage);
+
     /* Enter the corresponding interrupt handler routine. */
     status = this->execute_interrupt_handler(program_ctx, jump_vector_storage);
     if (PENES_STATUS_SUCCESS != status) {
@@ -144,6 +526,8 @@ enum PeNESStatus CPU::service_interrupts()
         goto l_cleanup;
     }
 
+    this->program_ctx->num_cycles += CPU_INTERRUPT_CYCLES;
+
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
     return status;
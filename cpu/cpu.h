@@ -8,6 +8,10 @@
 #define __CPU_H__
 
 /** Headers ***************************************************************/
+#include <array>
+#include <cstdint>
+#include <ostream>
+
 #include "penes_status.h"
 #include "system.h"
 
@@ -16,12 +20,63 @@
 #include "instruction_set/operation_types.h"
 
 /** Constants *************************************************************/
+#define CPU_NUM_OPCODES (0x100)
+#define CPU_RESET_CYCLES (7)
+#define CPU_INTERRUPT_CYCLES (7)
+/* An NTSC frame lasts 341 * 262 - 0.5 PPU dots on average, at 3 dots per CPU cycle, which is 29780.5 CPU cycles. */
+#define CPU_NTSC_CYCLES_PER_FRAME_NUMERATOR (59561)
+#define CPU_NTSC_CYCLES_PER_FRAME_DENOMINATOR (2)
+#define CPU_DEFAULT_RUN_NUM_FRAMES (60)
+/* The NTSC 2A03 divides the 236.25 / 11 MHz master clock by 12. */
+#define CPU_NTSC_CLOCK_RATE_HZ (19687500.0 / 11)
+#define CPU_NANOSECONDS_PER_SECOND (1000000000)
+/* About 60.0988 frames per second. */
+#define CPU_NTSC_FRAME_RATE_HZ \
+    (CPU_NTSC_CLOCK_RATE_HZ * CPU_NTSC_CYCLES_PER_FRAME_DENOMINATOR / CPU_NTSC_CYCLES_PER_FRAME_NUMERATOR)
+/* Sleeping wakes up late by up to the scheduler's latency, and so the last stretch before a frame deadline is spun. */
+#define CPU_PACING_SPIN_THRESHOLD_NS (1000000)
+
 /** Macros ****************************************************************/
 /** Enums *****************************************************************/
+enum CPUPacingMode {
+    CPU_PACING_MODE_NONE = -1,
+    /* Run as fast as possible, for batch work. */
+    CPU_PACING_MODE_UNTHROTTLED = 0,
+    /* Run at the NTSC frame rate. */
+    CPU_PACING_MODE_REAL_TIME,
+    /* Run at a multiple of the NTSC frame rate. */
+    CPU_PACING_MODE_MULTIPLIER,
+    CPU_PACING_MODE_NUM_PACING_MODES
+};
+
 /** Typedefs **************************************************************/
 /** Structs ***************************************************************/
+/** @brief The throughput of a run, measured with a monotonic clock. */
+struct CPUPerformanceReport {
+    std::uint64_t num_instructions = 0;
+    std::uint64_t num_cycles = 0;
+    std::uint64_t num_frames = 0;
+    double elapsed_seconds = 0;
+    double instructions_per_second = 0;
+    double cycles_per_second = 0;
+    double frames_per_second = 0;
+    /* The emulated cycles per second relative to the NTSC hardware clock, where 1 is real time. */
+    double speed_ratio = 0;
+
+    enum CPUPacingMode pacing_mode = CPU_PACING_MODE_UNTHROTTLED;
+    double speed_multiplier = 0;
+    /* The time between consecutive frame ends, including any time spent waiting for the frame's deadline. */
+    double min_frame_seconds = 0;
+    double mean_frame_seconds = 0;
+    double max_frame_seconds = 0;
+    /* The standard deviation of the frame time. */
+    double frame_jitter_seconds = 0;
+    /* The number of paced frames that were emulated past their deadline. */
+    std::uint64_t num_late_frames = 0;
+};
+
 /** Functions *************************************************************/
-class CPU : private instruction_set::IInterruptOperation {
+class CPU final : private instruction_set::IInterruptOperation {
 public:
     inline explicit CPU(ProgramContext *program_ctx):
         program_ctx(program_ctx), instruction_decoder(program_ctx)
@@ -29,15 +84,183 @@ public:
         ASSERT(nullptr != program_ctx);
     }
 
-    enum PeNESStatus run();
+    /** @brief          Select how the frames of a run are paced against the host clock.
+     *
+     *  @param[in]      pacing_mode                 The pacing mode.
+     *  @param[in]      speed_multiplier            The multiple of the NTSC frame rate to run at,
+     *                                              only used by the multiplier pacing mode.
+     * */
+    inline void set_pacing_mode(enum CPUPacingMode pacing_mode, double speed_multiplier = 1)
+    {
+        ASSERT((CPU_PACING_MODE_NONE < pacing_mode) && (CPU_PACING_MODE_NUM_PACING_MODES > pacing_mode));
+        ASSERT(0 < speed_multiplier);
 
-private:
+        this->pacing_mode = pacing_mode;
+        this->speed_multiplier = (CPU_PACING_MODE_MULTIPLIER == pacing_mode)? speed_multiplier: 1;
+    }
+
+    /** @brief          Reset the machine, and run it for a number of frames, paced by the selected pacing mode.
+     *
+     *  @param[in]      num_frames                  The number of frames to run.
+     *  @param[out]     output_report               Optional, the performance of the run.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus run(
+        std::size_t num_frames = CPU_DEFAULT_RUN_NUM_FRAMES,
+        struct CPUPerformanceReport *output_report = nullptr
+    );
+
+    /** @brief          Write a performance report, either as human readable text or as a JSON object.
+     *
+     *  @param[in]      report                      The report to write.
+     *  @param[in]      output_stream               The stream to write to.
+     *  @param[in]      is_json                     Whether to write the report as JSON.
+     * */
+    static void write_performance_report(
+        const struct CPUPerformanceReport& report,
+        std::ostream& output_stream,
+        bool is_json
+    );
+
+    /** @brief          Create a copy of the machine, which runs on a copy of its context.
+     *                  Creating a machine builds nothing, and so the copy costs no more than its context's copy.
+     *
+     *  @param[in]      clone_ctx                   The copy of the context, see ProgramContext::clone.
+     *                                              Must outlive the copy of the machine.
+     *  @param[out]     output_clone                The copy, to be deleted by the caller.
+     * */
+    inline void clone(ProgramContext *clone_ctx, CPU **output_clone) const
+    {
+        CPU *clone_cpu = nullptr;
+
+        ASSERT(nullptr != clone_ctx);
+        ASSERT(this->program_ctx != clone_ctx);
+        ASSERT(nullptr != output_clone);
+
+        clone_cpu = new CPU(clone_ctx);
+        clone_cpu->num_instructions = this->num_instructions;
+        clone_cpu->pacing_mode = this->pacing_mode;
+        clone_cpu->speed_multiplier = this->speed_multiplier;
+
+        *output_clone = clone_cpu;
+    }
+
+    /** @brief Reset the machine by jumping to the address at the reset interrupt vector.
+     *         Must be called once before the machine is run in slices.
+     * */
     enum PeNESStatus reset();
 
-    enum PeNESStatus service_interrupts();
+    /** @brief          Run until the cycle counter reaches a cycle, and return so that execution can later be resumed.
+     *
+     *  @param[in]      target_cycle                The cycle to stop at, counted since power on.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Instructions are never split, and so the last one may overshoot the target by a few cycles.
+     *                  Nothing runs if the target has already been reached.
+     * */
+    enum PeNESStatus run_until(std::uint64_t target_cycle);
+
+    /** @brief Run for a number of cycles from the current cycle. See run_until. */
+    inline enum PeNESStatus run_cycles(std::uint64_t num_cycles)
+    {
+        return this->run_until(this->program_ctx->num_cycles + num_cycles);
+    }
+
+    /** @brief Run until the end of the current NTSC frame.
+     *         Frame boundaries are fixed cycles since power on, and do not drift with instruction overshoot,
+     *         even when the machine was last stopped mid-frame by run_until.
+     * */
+    enum PeNESStatus step_frame();
+
+    /** @brief Execute a single instruction, and dispatch any event due after it. */
+    enum PeNESStatus step();
+
+    /** @brief Retrieve the number of CPU cycles elapsed since power on. */
+    inline std::uint64_t get_num_cycles() const
+    {
+        return this->program_ctx->num_cycles;
+    }
+
+    /** @brief Retrieve the number of frames completed, derived from the cycle counter. */
+    inline std::uint64_t get_num_frames() const
+    {
+        return this->program_ctx->num_cycles * CPU_NTSC_CYCLES_PER_FRAME_DENOMINATOR / CPU_NTSC_CYCLES_PER_FRAME_NUMERATOR;
+    }
+
+    inline std::uint64_t get_num_instructions() const
+    {
+        return this->num_instructions;
+    }
+
+    /** @brief Retrieve the address of the next instruction to execute. */
+    inline native_address_t get_program_counter()
+    {
+        return this->program_ctx->register_file.get_register_program_counter()->read();
+    }
+
+    /** @brief Read the monotonic clock, in nanoseconds. */
+    static enum PeNESStatus get_monotonic_time(std::uint64_t *output_time_ns);
+
+    /** @brief Retrieve the cycle a frame ends on. Frame boundaries are fixed cycles since power on. */
+    static inline std::uint64_t get_frame_end_cycle(std::uint64_t frame_index)
+    {
+        return (
+            (frame_index + 1) * CPU_NTSC_CYCLES_PER_FRAME_NUMERATOR + CPU_NTSC_CYCLES_PER_FRAME_DENOMINATOR - 1
+        ) / CPU_NTSC_CYCLES_PER_FRAME_DENOMINATOR;
+    }
+
+private:
+    /* The lockstep engine runs the common instructions of many machines itself, keeping their registers as vectors,
+     * and so it needs to be able to decode, account and dispatch the way the machine does, and is a friend.
+     * */
+    friend class LockstepEngine;
+
+    enum PeNESStatus execute_instruction();
+
+    /** @brief          Wait for a deadline of the monotonic clock.
+     *                  Sleeps until shortly before the deadline, and spins for the rest,
+     *                  which keeps the jitter low without keeping a core busy for the whole frame.
+     *
+     *  @param[in]      deadline_ns                 The deadline, in nanoseconds of the monotonic clock.
+     *  @param[out]     output_time_ns              The time the wait ended at.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus wait_until(std::uint64_t deadline_ns, std::uint64_t *output_time_ns);
+
+    /** @brief Dispatch every event that is due on the current cycle or earlier, in order. */
+    enum PeNESStatus dispatch_events();
+
+    enum PeNESStatus service_interrupt(MemoryStorage *jump_vector_storage);
+
+    /** @brief Add the cycles taken by an executed instruction to the cycle counter. */
+    inline void account_instruction_cycles(native_word_t opcode_data)
+    {
+        this->program_ctx->num_cycles += CPU::instruction_cycles[opcode_data] + this->program_ctx->num_branch_cycles;
+        if (true == this->program_ctx->did_cross_page) {
+            this->program_ctx->num_cycles += CPU::instruction_page_cross_cycles[opcode_data];
+        }
+
+        this->program_ctx->did_cross_page = false;
+        this->program_ctx->num_branch_cycles = 0;
+    }
 
     ProgramContext *program_ctx;
     Decoder instruction_decoder;
+    std::uint64_t num_instructions = 0;
+    enum CPUPacingMode pacing_mode = CPU_PACING_MODE_UNTHROTTLED;
+    double speed_multiplier = 1;
+
+    static const std::array<const char *, CPU_PACING_MODE_NUM_PACING_MODES> pacing_mode_names;
+
+    /** The base number of cycles of each opcode, indexed by the opcode byte. */
+    static const std::array<std::uint8_t, CPU_NUM_OPCODES> instruction_cycles;
+    /** The extra cycles of each opcode when its indexed address crosses a page.
+     *  Only reads take them, since writes and read-modify-writes always spend the cycle.
+     * */
+    static const std::array<std::uint8_t, CPU_NUM_OPCODES> instruction_page_cross_cycles;
 };
 
 
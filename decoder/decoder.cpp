@@ -249,6 +249,19 @@ const std::initializer_list<std::initializer_list<instruction_set::OpcodeType>>
 };
 
 /** Functions *************************************************************/
+const std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS>& Decoder::get_instruction_group_table()
+{
+    /* Function-local statics are initialized once, even when the first decoders are created concurrently. */
+    static const std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS> instruction_group_table = {
+        InstructionDecodeGroup(Decoder::address_mode_table_group_0, Decoder::opcode_tables_group_0),
+        InstructionDecodeGroup(Decoder::address_mode_table_group_1, Decoder::opcode_tables_group_1),
+        InstructionDecodeGroup(Decoder::address_mode_table_group_2, Decoder::opcode_tables_group_2)
+    };
+
+    return instruction_group_table;
+}
+
+
 InstructionDecodeGroup::InstructionDecodeGroup(
     std::initializer_list<enum address_mode::AddressModeType> address_mode_types,
     std::initializer_list<std::initializer_list<enum instruction_set::OpcodeType>> opcode_type_groups
@@ -267,12 +280,12 @@ enum PeNESStatus InstructionDecodeGroup::decode_instruction(
     native_word_t instruction_data,
     instruction_set::IOpcode **output_opcode,
     address_mode::IAddressMode **output_address_mode
-)
+) const
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
     std::size_t address_mode_encoding = DECODER_GET_ADDRESS_MODE_ENCODING(instruction_data);
     std::size_t opcode_encoding = DECODER_GET_OPCODE_ENCODING(instruction_data);
-    instruction_set::OpcodeTable *opcode_table = nullptr;
+    const instruction_set::OpcodeTable *opcode_table = nullptr;
     instruction_set::IOpcode *opcode = nullptr;
     address_mode::IAddressMode *address_mode = nullptr;
     enum address_mode::AddressModeType address_mode_type = address_mode::ADDRESS_MODE_TYPE_NONE;
@@ -332,20 +345,97 @@ l_cleanup:
 }
 
 
+enum PeNESStatus InstructionDecodeGroup::decode_opcode_type(
+    native_word_t instruction_data,
+    enum instruction_set::OpcodeType *output_opcode_type
+) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t address_mode_encoding = DECODER_GET_ADDRESS_MODE_ENCODING(instruction_data);
+    std::size_t opcode_encoding = DECODER_GET_OPCODE_ENCODING(instruction_data);
+
+    ASSERT(nullptr != output_opcode_type);
+
+    /* Retrieve the type of the opcode referred to by the encoded index, from the opcode table of the address mode. */
+    status = this->opcode_tables.at(address_mode_encoding)->get_type(opcode_encoding, output_opcode_type);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
+            "Opcode table get_type failed. Status: %d. Opcode encoding: %zu\n",
+            status,
+            opcode_encoding
+        );
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
 enum PeNESStatus Decoder::next_instruction(
     instruction_set::Instruction **output_instruction
 )
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    instruction_set::Instruction *instruction = nullptr;
+    instruction_set::IOpcode *instruction_opcode = nullptr;
+    address_mode::IAddressMode *instruction_address_mode = nullptr;
+    IStorageLocation *operand_storage = nullptr;
+    std::size_t operand_storage_offset = 0;
+    native_word_t instruction_opcode_data = 0;
+
+    ASSERT(nullptr != output_instruction);
+
+    status = this->decode_next_instruction(
+        &instruction_opcode,
+        &instruction_address_mode,
+        &operand_storage,
+        &operand_storage_offset,
+        &instruction_opcode_data
+    );
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("decode_next_instruction failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Create an instruction object. */
+    *output_instruction = new instruction_set::Instruction(
+        program_ctx,
+        instruction_opcode,
+        instruction_address_mode,
+        operand_storage,
+        operand_storage_offset,
+        instruction_opcode_data
+    );
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus Decoder::decode_next_instruction(
+    instruction_set::IOpcode **output_opcode,
+    address_mode::IAddressMode **output_address_mode,
+    IStorageLocation **output_operand_storage,
+    std::size_t *output_operand_storage_offset,
+    native_word_t *output_opcode_data
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
     RegisterStorage<native_address_t> *register_program_counter = nullptr;
     instruction_set::IOpcode *instruction_opcode = nullptr;
     address_mode::IAddressMode *instruction_address_mode = nullptr;
     IStorageLocation *operand_storage = nullptr;
     native_address_t program_counter_address = 0;
     std::size_t operand_storage_offset = 0;
+    native_word_t instruction_opcode_data = 0;
 
-    ASSERT(nullptr != output_instruction);
+    ASSERT(nullptr != output_opcode);
+    ASSERT(nullptr != output_address_mode);
+    ASSERT(nullptr != output_operand_storage);
+    ASSERT(nullptr != output_operand_storage_offset);
+    ASSERT(nullptr != output_opcode_data);
 
     /* Retrieve Program counter register from the program context. */
     register_program_counter = program_ctx->register_file.get_register_program_counter();
@@ -353,11 +443,15 @@ enum PeNESStatus Decoder::next_instruction(
     /* Read the current program counter address and verify that it is within the bounds of the source binary. */
     program_counter_address = register_program_counter->read();
 
+    /* Let the memory map know which instruction is about to perform any data accesses. */
+    program_ctx->memory_map.set_instruction_address(program_counter_address);
+
     /* Read and decode the instruction opcode at the current program counter address. */
     status = this->decode_opcode(
         &program_counter_address,
         &instruction_opcode,
-        &instruction_address_mode
+        &instruction_address_mode,
+        &instruction_opcode_data
     );
     if (PENES_STATUS_SUCCESS != status) {
         DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("decode_opcode failed. Status: %d.\n", status);
@@ -376,19 +470,46 @@ enum PeNESStatus Decoder::next_instruction(
         goto l_cleanup;
     }
 
-    /* Create an instruction object. */
-    instruction = new instruction_set::Instruction(
-        program_ctx,
-        instruction_opcode,
-        instruction_address_mode,
-        operand_storage,
-        operand_storage_offset
-    );
-
     /* Write the updated program counter back to the Program counter register. */
     register_program_counter->write(program_counter_address);
 
-    *output_instruction = instruction;
+    *output_opcode = instruction_opcode;
+    *output_address_mode = instruction_address_mode;
+    *output_operand_storage = operand_storage;
+    *output_operand_storage_offset = operand_storage_offset;
+    *output_opcode_data = instruction_opcode_data;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus Decoder::get_opcode_type(
+    native_word_t opcode_data,
+    enum instruction_set::OpcodeType *output_opcode_type
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    const std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS> *instruction_group_table = nullptr;
+    std::size_t instruction_group_index = DECODER_GET_INSTRUCTION_GROUP_ENCODING(opcode_data);
+
+    ASSERT(nullptr != output_opcode_type);
+
+    instruction_group_table = &Decoder::get_instruction_group_table();
+
+    /* No opcode is encoded in the last instruction group, which decoding an instruction fails on instead. */
+    if (instruction_group_table->size() <= instruction_group_index) {
+        *output_opcode_type = instruction_set::OPCODE_TYPE_NONE;
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    status = instruction_group_table->at(instruction_group_index).decode_opcode_type(opcode_data, output_opcode_type);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("decode_opcode_type failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
 
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
@@ -399,11 +520,12 @@ l_cleanup:
 enum PeNESStatus Decoder::decode_opcode(
     native_address_t *decode_address,
     instruction_set::IOpcode **output_opcode,
-    address_mode::IAddressMode **output_address_mode
+    address_mode::IAddressMode **output_address_mode,
+    native_word_t *output_opcode_data
 )
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    InstructionDecodeGroup *instruction_group = nullptr;
+    const InstructionDecodeGroup *instruction_group = nullptr;
     instruction_set::IOpcode *instruction_opcode = nullptr;
     address_mode::IAddressMode *instruction_address_mode = nullptr;
     native_word_t instruction_opcode_data = 0;
@@ -412,6 +534,7 @@ enum PeNESStatus Decoder::decode_opcode(
     ASSERT(nullptr != decode_address);
     ASSERT(nullptr != output_opcode);
     ASSERT(nullptr != output_address_mode);
+    ASSERT(nullptr != output_opcode_data);
 
     /* Read the instruction opcode at the decode address. */
     status = read_instruction_data(
@@ -431,7 +554,7 @@ enum PeNESStatus Decoder::decode_opcode(
     /* Extract the encoded instruction group index and verify it's within range of the table. */
     instruction_group_index = DECODER_GET_INSTRUCTION_GROUP_ENCODING(instruction_opcode_data);
 
-    if (Decoder::instruction_group_table.size() <= instruction_group_index) {
+    if (this->instruction_group_table->size() <= instruction_group_index) {
         status = PENES_STATUS_DECODER_DECODE_OPCODE_GROUP_OUT_OF_BOUNDS;
         DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
             "Encoded instruction group out of bounds. Status: %d. Instruction group: %zu\n",
@@ -443,7 +566,7 @@ enum PeNESStatus Decoder::decode_opcode(
 
     /* TODO convert to reference? */
     /* Decode the rest of the opcode according to the parsed group. */
-    instruction_group = &this->instruction_group_table.at(instruction_group_index);
+    instruction_group = &this->instruction_group_table->at(instruction_group_index);
 
     status = instruction_group->decode_instruction(
         instruction_opcode_data,
@@ -461,6 +584,7 @@ enum PeNESStatus Decoder::decode_opcode(
 
     *output_opcode = instruction_opcode;
     *output_address_mode = instruction_address_mode;
+    *output_opcode_data = instruction_opcode_data;
 
     /* Advance the decode address to reflect the new program counter value. */
     *decode_address += sizeof(instruction_opcode_data);
@@ -566,13 +690,13 @@ enum PeNESStatus Decoder::read_instruction_data(
     }
 
     if (PENES_STATUS_SUCCESS != status) {
-        status = this->program_ctx->memory_map.get_memory_storage(
+        status = this->program_ctx->memory_map.get_instruction_storage(
             read_address,
             &this->prg_rom_storage,
             &new_storage_bank_offset
         );
         if (PENES_STATUS_SUCCESS != status) {
-            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_memory_storage failed. Status: %d.\n", status);
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_instruction_storage failed. Status: %d.\n", status);
             goto l_cleanup;
         }
 
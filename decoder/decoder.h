@@ -33,11 +33,16 @@ public:
         this->opcode_tables.clear();
     };
 
-    inline enum PeNESStatus decode_instruction(
+    enum PeNESStatus decode_instruction(
         native_word_t instruction_data,
         instruction_set::IOpcode **output_opcode,
         address_mode::IAddressMode **output_address_mode
-    );
+    ) const;
+
+    enum PeNESStatus decode_opcode_type(
+        native_word_t instruction_data,
+        enum instruction_set::OpcodeType *output_opcode_type
+    ) const;
 
 private:
     address_mode::AddressModeTable address_mode_table;
@@ -49,11 +54,7 @@ class Decoder {
 public:
     inline explicit Decoder(ProgramContext *program_ctx):
         program_ctx(program_ctx),
-        instruction_group_table({
-            InstructionDecodeGroup(address_mode_table_group_0, opcode_tables_group_0),
-            InstructionDecodeGroup(address_mode_table_group_1, opcode_tables_group_1),
-            InstructionDecodeGroup(address_mode_table_group_2, opcode_tables_group_2)
-        })
+        instruction_group_table(&Decoder::get_instruction_group_table())
     {
         ASSERT(nullptr != program_ctx);
     }
@@ -62,11 +63,57 @@ public:
         instruction_set::Instruction **output_instruction
     );
 
+    /** @brief          Decode the instruction at the program counter without executing it,
+     *                  and advance the program counter past it, as next_instruction does.
+     *
+     *  @param[out]     output_opcode               The opcode of the instruction.
+     *  @param[out]     output_address_mode         The address mode of the instruction,
+     *                                              which the operand storage must be released through once done with.
+     *  @param[out]     output_operand_storage      The storage location of the operand.
+     *  @param[out]     output_operand_storage_offset
+     *                                              The offset of the operand within its storage location.
+     *  @param[out]     output_opcode_data          The encoded opcode byte.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus decode_next_instruction(
+        instruction_set::IOpcode **output_opcode,
+        address_mode::IAddressMode **output_address_mode,
+        IStorageLocation **output_operand_storage,
+        std::size_t *output_operand_storage_offset,
+        native_word_t *output_opcode_data
+    );
+
+    /** @brief Read the opcode byte at the program counter, without decoding it or advancing the program counter. */
+    inline enum PeNESStatus peek_opcode_data(native_word_t *output_opcode_data)
+    {
+        ASSERT(nullptr != output_opcode_data);
+
+        return this->read_instruction_data(
+            this->program_ctx->register_file.get_register_program_counter()->read(),
+            output_opcode_data,
+            sizeof(*output_opcode_data)
+        );
+    }
+
+    /** @brief          Decode the type of the opcode encoded by an opcode byte, without reading any memory.
+     *
+     *  @param[in]      opcode_data                 The encoded opcode byte.
+     *  @param[out]     output_opcode_type          The type of the opcode, OPCODE_TYPE_NONE for an unused encoding.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus get_opcode_type(
+        native_word_t opcode_data,
+        enum instruction_set::OpcodeType *output_opcode_type
+    );
+
 private:
     enum PeNESStatus decode_opcode(
         native_address_t *decode_address,
         instruction_set::IOpcode **output_opcode,
-        address_mode::IAddressMode **output_address_mode
+        address_mode::IAddressMode **output_address_mode,
+        native_word_t *output_opcode_data
     );
 
     enum PeNESStatus decode_operand(
@@ -97,7 +144,14 @@ private:
     static const std::initializer_list<std::initializer_list<instruction_set::OpcodeType>> opcode_tables_group_1;
     static const std::initializer_list<std::initializer_list<instruction_set::OpcodeType>> opcode_tables_group_2;
 
-    std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS> instruction_group_table;
+    /** @brief Retrieve the decode table shared by every decoder, built on first use.
+     *         The table only refers to the shared opcode and address mode instances, and is never modified,
+     *         and so a single one serves the decoders of all threads, and creating a decoder builds nothing.
+     * */
+    static const std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS>&
+        get_instruction_group_table();
+
+    const std::array<InstructionDecodeGroup, DECODER_NUM_INSTRUCTION_DECODE_GROUPS> *instruction_group_table;
 };
 
 #endif /* __DECODER_H__ */
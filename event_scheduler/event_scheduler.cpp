@@ -0,0 +1,92 @@
+/**
+ * @brief  Cycle-timestamped scheduler of the machine's timed events, such as interrupts and frame boundaries.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <algorithm>
+#include <cstdint>
+
+#include "common.h"
+
+#include "event_scheduler/event_scheduler.h"
+
+/** Functions *************************************************************/
+/** @brief Order events so that the heap top is the earliest event, and the highest priority one among ties. */
+static inline bool is_later_event(const struct EventSchedulerEvent& first_event, const struct EventSchedulerEvent& second_event)
+{
+    if (first_event.cycle != second_event.cycle) {
+        return first_event.cycle > second_event.cycle;
+    }
+
+    return first_event.type > second_event.type;
+}
+
+
+void EventScheduler::schedule(enum EventSchedulerEventType event_type, std::uint64_t cycle)
+{
+    ASSERT(EVENT_SCHEDULER_EVENT_TYPE_NUM_EVENT_TYPES > event_type);
+    ASSERT(EVENT_SCHEDULER_EVENT_TYPE_NONE < event_type);
+
+    this->deadlines[event_type] = cycle;
+
+    this->event_heap.push_back({cycle, event_type});
+    std::push_heap(this->event_heap.begin(), this->event_heap.end(), is_later_event);
+}
+
+
+void EventScheduler::clear()
+{
+    this->deadlines.fill(EVENT_SCHEDULER_NO_DEADLINE);
+    this->event_heap.clear();
+}
+
+
+std::uint64_t EventScheduler::get_next_deadline()
+{
+    this->discard_stale_events();
+
+    if (true == this->event_heap.empty()) {
+        return EVENT_SCHEDULER_NO_DEADLINE;
+    }
+
+    return this->event_heap.front().cycle;
+}
+
+
+bool EventScheduler::pop_due_event(std::uint64_t current_cycle, enum EventSchedulerEventType *output_event_type)
+{
+    enum EventSchedulerEventType event_type = EVENT_SCHEDULER_EVENT_TYPE_NONE;
+
+    ASSERT(nullptr != output_event_type);
+
+    this->discard_stale_events();
+
+    if ((true == this->event_heap.empty()) || (current_cycle < this->event_heap.front().cycle)) {
+        return false;
+    }
+
+    event_type = this->event_heap.front().type;
+
+    std::pop_heap(this->event_heap.begin(), this->event_heap.end(), is_later_event);
+    this->event_heap.pop_back();
+
+    /* The event is no longer pending, and so any duplicate entry of it becomes stale. */
+    this->deadlines[event_type] = EVENT_SCHEDULER_NO_DEADLINE;
+
+    *output_event_type = event_type;
+
+    return true;
+}
+
+
+void EventScheduler::discard_stale_events()
+{
+    /* An entry is stale once its event has been cancelled, dispatched or rescheduled to another cycle. */
+    while ((false == this->event_heap.empty()) &&
+           (this->deadlines[this->event_heap.front().type] != this->event_heap.front().cycle)) {
+        std::pop_heap(this->event_heap.begin(), this->event_heap.end(), is_later_event);
+        this->event_heap.pop_back();
+    }
+}
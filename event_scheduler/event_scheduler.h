@@ -0,0 +1,97 @@
+/**
+ * @brief  Cycle-timestamped scheduler of the machine's timed events, such as interrupts and frame boundaries.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __EVENT_SCHEDULER_H__
+#define __EVENT_SCHEDULER_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "common.h"
+
+/** Constants *************************************************************/
+#define EVENT_SCHEDULER_NO_DEADLINE (std::numeric_limits<std::uint64_t>::max())
+
+/** Enums *****************************************************************/
+/** @brief The timed events of the machine. Events due on the same cycle are dispatched in this order. */
+enum EventSchedulerEventType {
+    EVENT_SCHEDULER_EVENT_TYPE_NONE = -1,
+    EVENT_SCHEDULER_EVENT_TYPE_NMI = 0,
+    EVENT_SCHEDULER_EVENT_TYPE_IRQ,
+    EVENT_SCHEDULER_EVENT_TYPE_FRAME_END,
+    EVENT_SCHEDULER_EVENT_TYPE_NUM_EVENT_TYPES
+};
+
+/** Structs ***************************************************************/
+struct EventSchedulerEvent {
+    std::uint64_t cycle;
+    enum EventSchedulerEventType type;
+};
+
+/** Classes ***************************************************************/
+/** @brief A binary min-heap of events ordered by cycle, holding at most one pending event of each type.
+ *         Rescheduling or cancelling an event leaves its old heap entry behind,
+ *         which is recognized as stale and discarded once it reaches the top.
+ * */
+class EventScheduler {
+public:
+    inline EventScheduler()
+    {
+        this->deadlines.fill(EVENT_SCHEDULER_NO_DEADLINE);
+    }
+
+    /** @brief          Schedule an event, replacing its pending occurrence if there is one.
+     *
+     *  @param[in]      event_type                  The type of the event.
+     *  @param[in]      cycle                       The CPU cycle the event is due on.
+     *                                              An event due on a past cycle is dispatched at the next opportunity.
+     * */
+    void schedule(enum EventSchedulerEventType event_type, std::uint64_t cycle);
+
+    inline void cancel(enum EventSchedulerEventType event_type)
+    {
+        ASSERT(EVENT_SCHEDULER_EVENT_TYPE_NUM_EVENT_TYPES > event_type);
+
+        this->deadlines[event_type] = EVENT_SCHEDULER_NO_DEADLINE;
+    }
+
+    /** @brief Cancel every pending event. */
+    void clear();
+
+    /** @brief Retrieve the cycle an event is due on, or EVENT_SCHEDULER_NO_DEADLINE if it is not scheduled. */
+    inline std::uint64_t get_deadline(enum EventSchedulerEventType event_type) const
+    {
+        ASSERT(EVENT_SCHEDULER_EVENT_TYPE_NUM_EVENT_TYPES > event_type);
+
+        return this->deadlines[event_type];
+    }
+
+    /** @brief Retrieve the cycle the earliest pending event is due on, or EVENT_SCHEDULER_NO_DEADLINE if there is none. */
+    std::uint64_t get_next_deadline();
+
+    /** @brief          Remove the earliest pending event if it is due.
+     *
+     *  @param[in]      current_cycle               The current CPU cycle.
+     *  @param[out]     output_event_type           The type of the due event.
+     *
+     *  @return         Whether an event was due.
+     * */
+    bool pop_due_event(std::uint64_t current_cycle, enum EventSchedulerEventType *output_event_type);
+
+private:
+    /** @brief Discard the stale entries at the top of the heap, so that the top is a pending event. */
+    void discard_stale_events();
+
+    std::array<std::uint64_t, EVENT_SCHEDULER_EVENT_TYPE_NUM_EVENT_TYPES> deadlines;
+    std::vector<struct EventSchedulerEvent> event_heap;
+};
+
+
+#endif /* __EVENT_SCHEDULER_H__ */
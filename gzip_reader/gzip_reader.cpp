@@ -0,0 +1,898 @@
+/**
+ * @brief  Streaming reader of gzip compressed files, with a self-contained inflate implementation.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "utils/checksum.h"
+
+#include "gzip_reader/gzip_reader.h"
+
+/** Constants *************************************************************/
+#define GZIP_READER_MAGIC_FIRST_BYTE (0x1F)
+#define GZIP_READER_MAGIC_SECOND_BYTE (0x8B)
+#define GZIP_READER_METHOD_DEFLATE (8)
+#define GZIP_READER_FLAG_HEADER_CRC (1 << 1)
+#define GZIP_READER_FLAG_EXTRA (1 << 2)
+#define GZIP_READER_FLAG_NAME (1 << 3)
+#define GZIP_READER_FLAG_COMMENT (1 << 4)
+/* The modification time, extra flags and operating system fields, which are not needed. */
+#define GZIP_READER_IGNORED_HEADER_FIELDS_SIZE (6)
+#define GZIP_READER_EXTRA_LENGTH_SIZE (2)
+#define GZIP_READER_HEADER_CRC_SIZE (2)
+#define GZIP_READER_TRAILER_FIELD_SIZE (4)
+/* A deflate stream expands by at most 1032 times, since the longest match, of 258 bytes, takes at least 2 bits. */
+#define GZIP_READER_MAX_EXPANSION_RATIO (1032)
+
+#define GZIP_READER_BLOCK_FINAL_BITS (1)
+#define GZIP_READER_BLOCK_TYPE_BITS (2)
+#define GZIP_READER_STORED_LENGTH_SIZE (2)
+#define GZIP_READER_STORED_LENGTH_MASK (0xFFFF)
+
+#define GZIP_READER_END_OF_BLOCK_SYMBOL (256)
+#define GZIP_READER_FIRST_LENGTH_SYMBOL (257)
+#define GZIP_READER_NUM_LENGTH_SYMBOLS (29)
+#define GZIP_READER_NUM_LITERAL_LENGTH_COUNT_BITS (5)
+#define GZIP_READER_NUM_DISTANCE_COUNT_BITS (5)
+#define GZIP_READER_NUM_CODE_LENGTH_COUNT_BITS (4)
+#define GZIP_READER_MIN_NUM_CODE_LENGTH_CODES (4)
+#define GZIP_READER_CODE_LENGTH_CODE_BITS (3)
+#define GZIP_READER_REPEAT_PREVIOUS_SYMBOL (16)
+#define GZIP_READER_REPEAT_ZERO_SYMBOL (17)
+#define GZIP_READER_REPEAT_ZERO_LONG_SYMBOL (18)
+
+#define GZIP_READER_DISCARD_BUFFER_SIZE (0x1000)
+
+/** Static Variables ******************************************************/
+/* The base length and number of extra bits of each length symbol, from RFC 1951. */
+static const std::uint16_t gzip_reader_length_bases[GZIP_READER_NUM_LENGTH_SYMBOLS] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const std::uint8_t gzip_reader_length_extra_bits[GZIP_READER_NUM_LENGTH_SYMBOLS] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+/* The base distance and number of extra bits of each distance symbol. */
+static const std::uint16_t gzip_reader_distance_bases[GZIP_READER_NUM_DISTANCE_CODES] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const std::uint8_t gzip_reader_distance_extra_bits[GZIP_READER_NUM_DISTANCE_CODES] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/* The order in which the code lengths of the code length code are stored. */
+static const std::uint8_t gzip_reader_code_length_order[GZIP_READER_NUM_CODE_LENGTH_CODES] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+/** Functions *************************************************************/
+enum PeNESStatus GzipReader::open(const std::string& input_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    /* Reset the state of the previous file in case it was open. */
+    this->input_file_stream.close();
+    this->input_buffer_offset = 0;
+    this->input_buffer_size = 0;
+    this->bit_buffer = 0;
+    this->num_buffered_bits = 0;
+    this->total_output_size = 0;
+    this->output_crc32 = 0;
+    this->block_type = GZIP_READER_BLOCK_TYPE_NONE;
+    this->is_final_block = false;
+    this->is_end_of_data = false;
+    this->stored_block_remaining_size = 0;
+    this->match_remaining_length = 0;
+    this->match_distance = 0;
+
+    this->input_file_stream.open(input_file, std::ifstream::in | std::ifstream::binary);
+    if (true == this->input_file_stream.fail()) {
+        status = PENES_STATUS_GZIP_READER_OPEN_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the input file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->read_member_header();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_member_header failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read(native_word_t *output_buffer, std::size_t num_bytes, std::size_t *output_num_read)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t num_read = 0;
+    std::uint16_t symbol = 0;
+    std::uint32_t extra_bits = 0;
+    std::uint8_t stored_byte = 0;
+
+    ASSERT((nullptr != output_buffer) || (0 == num_bytes));
+    ASSERT(nullptr != output_num_read);
+
+    while (num_read < num_bytes) {
+        /* Copy the rest of the current back-reference first. */
+        if (0 < this->match_remaining_length) {
+            this->emit_byte(
+                &output_buffer[num_read],
+                this->window[(this->total_output_size - this->match_distance) % GZIP_READER_WINDOW_SIZE]
+            );
+            num_read++;
+            this->match_remaining_length--;
+            continue;
+        }
+
+        if (true == this->is_end_of_data) {
+            break;
+        }
+
+        /* Start the next block, unless the last one has ended. */
+        if (GZIP_READER_BLOCK_TYPE_NONE == this->block_type) {
+            if (true == this->is_final_block) {
+                this->is_end_of_data = true;
+                continue;
+            }
+
+            status = this->read_block_header();
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_block_header failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+
+            continue;
+        }
+
+        if (GZIP_READER_BLOCK_TYPE_STORED == this->block_type) {
+            if (0 == this->stored_block_remaining_size) {
+                this->block_type = GZIP_READER_BLOCK_TYPE_NONE;
+                continue;
+            }
+
+            status = this->read_aligned_byte(&stored_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+
+            this->emit_byte(&output_buffer[num_read], stored_byte);
+            num_read++;
+            this->stored_block_remaining_size--;
+            continue;
+        }
+
+        /* A Huffman block symbol is either a literal, the end of the block, or the length of a back-reference. */
+        status = this->decode_symbol(*this->literal_length_code, &symbol);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("decode_symbol failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        if (GZIP_READER_END_OF_BLOCK_SYMBOL > symbol) {
+            this->emit_byte(&output_buffer[num_read], static_cast<native_word_t>(symbol));
+            num_read++;
+            continue;
+        }
+
+        if (GZIP_READER_END_OF_BLOCK_SYMBOL == symbol) {
+            this->block_type = GZIP_READER_BLOCK_TYPE_NONE;
+            continue;
+        }
+
+        symbol -= GZIP_READER_FIRST_LENGTH_SYMBOL;
+        if (GZIP_READER_NUM_LENGTH_SYMBOLS <= symbol) {
+            status = PENES_STATUS_GZIP_READER_READ_INVALID_SYMBOL;
+            DEBUG_PRINT_WITH_ARGS("Invalid length symbol. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        status = this->read_bits(gzip_reader_length_extra_bits[symbol], &extra_bits);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->match_remaining_length = gzip_reader_length_bases[symbol] + extra_bits;
+
+        status = this->decode_symbol(*this->distance_code, &symbol);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("decode_symbol failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        status = this->read_bits(gzip_reader_distance_extra_bits[symbol], &extra_bits);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->match_distance = gzip_reader_distance_bases[symbol] + extra_bits;
+        if (this->total_output_size < this->match_distance) {
+            status = PENES_STATUS_GZIP_READER_READ_INVALID_DISTANCE;
+            DEBUG_PRINT_WITH_ARGS("The distance is before the start of the data. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    this->output_crc32 = utils::calculate_crc32(output_buffer, num_read, this->output_crc32);
+    *output_num_read = num_read;
+
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::finish()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    native_word_t discard_buffer[GZIP_READER_DISCARD_BUFFER_SIZE] = {0};
+    std::size_t num_read = 0;
+    std::uint32_t expected_crc32 = 0;
+    std::uint32_t expected_size = 0;
+    std::uint8_t trailer_byte = 0;
+    std::size_t byte_index = 0;
+
+    do {
+        status = this->read(discard_buffer, sizeof(discard_buffer), &num_read);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    } while (0 < num_read);
+
+    /* The trailer holds the CRC-32 and the size of the data, both little endian. */
+    this->align_to_byte();
+
+    for (byte_index = 0; byte_index < GZIP_READER_TRAILER_FIELD_SIZE * 2; byte_index++) {
+        status = this->read_aligned_byte(&trailer_byte);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        if (GZIP_READER_TRAILER_FIELD_SIZE > byte_index) {
+            expected_crc32 |= static_cast<std::uint32_t>(trailer_byte) << (byte_index * SYSTEM_NATIVE_WORD_SIZE_BITS);
+        } else {
+            expected_size |= static_cast<std::uint32_t>(trailer_byte) <<
+                             ((byte_index - GZIP_READER_TRAILER_FIELD_SIZE) * SYSTEM_NATIVE_WORD_SIZE_BITS);
+        }
+    }
+
+    if (expected_crc32 != this->output_crc32) {
+        status = PENES_STATUS_GZIP_READER_FINISH_CRC32_MISMATCH;
+        DEBUG_PRINT_WITH_ARGS("The data does not match its CRC-32. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (expected_size != static_cast<std::uint32_t>(this->total_output_size)) {
+        status = PENES_STATUS_GZIP_READER_FINISH_SIZE_MISMATCH;
+        DEBUG_PRINT_WITH_ARGS("The data does not match its size. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+bool GzipReader::is_gzip_file(const std::string& input_file)
+{
+    std::ifstream input_file_stream(input_file, std::ifstream::in | std::ifstream::binary);
+    std::uint8_t magic_buffer[GZIP_READER_MAGIC_SIZE] = {0};
+
+    input_file_stream.read(reinterpret_cast<char *>(magic_buffer), sizeof(magic_buffer));
+
+    return (false == input_file_stream.fail()) &&
+           (GZIP_READER_MAGIC_FIRST_BYTE == magic_buffer[0]) &&
+           (GZIP_READER_MAGIC_SECOND_BYTE == magic_buffer[1]);
+}
+
+
+enum PeNESStatus GzipReader::get_decompressed_size(const std::string& input_file, std::size_t *output_size)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ifstream input_file_stream;
+    std::uint8_t size_buffer[GZIP_READER_TRAILER_FIELD_SIZE] = {0};
+    std::size_t compressed_size = 0;
+    std::size_t decompressed_size = 0;
+    std::size_t byte_index = 0;
+
+    ASSERT(nullptr != output_size);
+
+    input_file_stream.open(input_file, std::ifstream::in | std::ifstream::binary);
+    if (true == input_file_stream.fail()) {
+        status = PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the input file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    input_file_stream.seekg(0, std::ifstream::end);
+    compressed_size = input_file_stream.tellg();
+
+    /* The size is the last field of the trailer, at the very end of the file. */
+    input_file_stream.seekg(-GZIP_READER_TRAILER_FIELD_SIZE, std::ifstream::end);
+    input_file_stream.read(reinterpret_cast<char *>(size_buffer), sizeof(size_buffer));
+    if (true == input_file_stream.fail()) {
+        status = PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_READ_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to read the trailer. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    for (byte_index = 0; byte_index < sizeof(size_buffer); byte_index++) {
+        decompressed_size |= static_cast<std::size_t>(size_buffer[byte_index]) << (byte_index * SYSTEM_NATIVE_WORD_SIZE_BITS);
+    }
+
+    /* The trailer is not verified until the data is, and so a size the data could not possibly expand to is rejected,
+     * since callers allocate by it.
+     * */
+    if (compressed_size * GZIP_READER_MAX_EXPANSION_RATIO < decompressed_size) {
+        status = PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_INVALID_SIZE;
+        DEBUG_PRINT_WITH_ARGS("The size in the trailer is larger than the data can expand to. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    *output_size = decompressed_size;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_member_header()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint8_t header_byte = 0;
+    std::uint8_t magic_buffer[GZIP_READER_MAGIC_SIZE] = {0};
+    std::uint8_t method = 0;
+    std::uint8_t flags = 0;
+    std::size_t num_skipped_bytes = 0;
+    std::size_t byte_index = 0;
+
+    for (byte_index = 0; byte_index < sizeof(magic_buffer); byte_index++) {
+        status = this->read_aligned_byte(&magic_buffer[byte_index]);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    if ((GZIP_READER_MAGIC_FIRST_BYTE != magic_buffer[0]) || (GZIP_READER_MAGIC_SECOND_BYTE != magic_buffer[1])) {
+        status = PENES_STATUS_GZIP_READER_READ_MEMBER_HEADER_INVALID_MAGIC;
+        DEBUG_PRINT_WITH_ARGS("Not a gzip file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->read_aligned_byte(&method);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (GZIP_READER_METHOD_DEFLATE != method) {
+        status = PENES_STATUS_GZIP_READER_READ_MEMBER_HEADER_UNSUPPORTED_METHOD;
+        DEBUG_PRINT_WITH_ARGS("Unsupported compression method. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->read_aligned_byte(&flags);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Skip the fixed fields, and then every optional field present. */
+    for (byte_index = 0; byte_index < GZIP_READER_IGNORED_HEADER_FIELDS_SIZE; byte_index++) {
+        status = this->read_aligned_byte(&header_byte);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    if (0 != (flags & GZIP_READER_FLAG_EXTRA)) {
+        /* The extra field is preceded by its little endian length. */
+        for (byte_index = 0; byte_index < GZIP_READER_EXTRA_LENGTH_SIZE; byte_index++) {
+            status = this->read_aligned_byte(&header_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+
+            num_skipped_bytes |= static_cast<std::size_t>(header_byte) << (byte_index * SYSTEM_NATIVE_WORD_SIZE_BITS);
+        }
+
+        for (byte_index = 0; byte_index < num_skipped_bytes; byte_index++) {
+            status = this->read_aligned_byte(&header_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        }
+    }
+
+    /* The original file name and the comment are null terminated. */
+    for (std::uint8_t string_flag : {GZIP_READER_FLAG_NAME, GZIP_READER_FLAG_COMMENT}) {
+        if (0 == (flags & string_flag)) {
+            continue;
+        }
+
+        do {
+            status = this->read_aligned_byte(&header_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        } while (NULL_TERMINATOR != header_byte);
+    }
+
+    if (0 != (flags & GZIP_READER_FLAG_HEADER_CRC)) {
+        for (byte_index = 0; byte_index < GZIP_READER_HEADER_CRC_SIZE; byte_index++) {
+            status = this->read_aligned_byte(&header_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_block_header()
+{
+    /* The fixed Huffman codes never change, and so they are built once, on first use. */
+    static const gzip_reader_literal_length_code_t fixed_literal_length_code = []() {
+        gzip_reader_literal_length_code_t code = {};
+        std::uint8_t code_lengths[GZIP_READER_NUM_LITERAL_LENGTH_CODES] = {0};
+        std::size_t symbol = 0;
+
+        for (symbol = 0; symbol < GZIP_READER_NUM_LITERAL_LENGTH_CODES; symbol++) {
+            code_lengths[symbol] = (144 > symbol)? 8: (256 > symbol)? 9: (280 > symbol)? 7: 8;
+        }
+
+        GzipReader::build_code(code_lengths, GZIP_READER_NUM_LITERAL_LENGTH_CODES, &code);
+
+        return code;
+    }();
+    static const gzip_reader_distance_code_t fixed_distance_code = []() {
+        gzip_reader_distance_code_t code = {};
+        std::uint8_t code_lengths[GZIP_READER_NUM_DISTANCE_CODES] = {0};
+        std::size_t symbol = 0;
+
+        for (symbol = 0; symbol < GZIP_READER_NUM_DISTANCE_CODES; symbol++) {
+            code_lengths[symbol] = 5;
+        }
+
+        GzipReader::build_code(code_lengths, GZIP_READER_NUM_DISTANCE_CODES, &code);
+
+        return code;
+    }();
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint32_t header_bits = 0;
+    std::uint8_t length_byte = 0;
+    std::size_t stored_length = 0;
+    std::size_t stored_length_complement = 0;
+    std::size_t byte_index = 0;
+
+    status = this->read_bits(GZIP_READER_BLOCK_FINAL_BITS, &header_bits);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->is_final_block = (0 != header_bits);
+
+    status = this->read_bits(GZIP_READER_BLOCK_TYPE_BITS, &header_bits);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    switch (static_cast<enum GzipReaderBlockType>(header_bits)) {
+    case GZIP_READER_BLOCK_TYPE_STORED:
+        /* A stored block starts at a byte boundary, with its length followed by the length's complement. */
+        this->align_to_byte();
+
+        for (byte_index = 0; byte_index < GZIP_READER_STORED_LENGTH_SIZE * 2; byte_index++) {
+            status = this->read_aligned_byte(&length_byte);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("read_aligned_byte failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+
+            if (GZIP_READER_STORED_LENGTH_SIZE > byte_index) {
+                stored_length |= static_cast<std::size_t>(length_byte) << (byte_index * SYSTEM_NATIVE_WORD_SIZE_BITS);
+            } else {
+                stored_length_complement |= static_cast<std::size_t>(length_byte) <<
+                                            ((byte_index - GZIP_READER_STORED_LENGTH_SIZE) * SYSTEM_NATIVE_WORD_SIZE_BITS);
+            }
+        }
+
+        if (stored_length != (~stored_length_complement & GZIP_READER_STORED_LENGTH_MASK)) {
+            status = PENES_STATUS_GZIP_READER_READ_BLOCK_HEADER_INVALID_STORED_LENGTH;
+            DEBUG_PRINT_WITH_ARGS("Invalid stored block length. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->stored_block_remaining_size = stored_length;
+        break;
+
+    case GZIP_READER_BLOCK_TYPE_FIXED_HUFFMAN:
+        this->literal_length_code = &fixed_literal_length_code;
+        this->distance_code = &fixed_distance_code;
+        break;
+
+    case GZIP_READER_BLOCK_TYPE_DYNAMIC_HUFFMAN:
+        status = this->read_dynamic_codes();
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_dynamic_codes failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->literal_length_code = &this->dynamic_literal_length_code;
+        this->distance_code = &this->dynamic_distance_code;
+        break;
+
+    default:
+        status = PENES_STATUS_GZIP_READER_READ_BLOCK_HEADER_INVALID_TYPE;
+        DEBUG_PRINT_WITH_ARGS("Invalid block type. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->block_type = static_cast<enum GzipReaderBlockType>(header_bits);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_dynamic_codes()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct GzipReaderHuffmanCode<GZIP_READER_NUM_CODE_LENGTH_CODES> code_length_code = {};
+    std::uint8_t code_length_code_lengths[GZIP_READER_NUM_CODE_LENGTH_CODES] = {0};
+    std::uint8_t code_lengths[GZIP_READER_NUM_LITERAL_LENGTH_CODES + GZIP_READER_NUM_DISTANCE_CODES] = {0};
+    std::uint32_t count_bits = 0;
+    std::size_t num_literal_length_codes = 0;
+    std::size_t num_distance_codes = 0;
+    std::size_t num_code_length_codes = 0;
+    std::size_t code_index = 0;
+    std::size_t num_repeats = 0;
+    std::uint8_t repeated_length = 0;
+    std::uint16_t symbol = 0;
+    std::uint32_t repeat_bits = 0;
+
+    status = this->read_bits(GZIP_READER_NUM_LITERAL_LENGTH_COUNT_BITS, &count_bits);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    num_literal_length_codes = count_bits + GZIP_READER_FIRST_LENGTH_SYMBOL;
+
+    status = this->read_bits(GZIP_READER_NUM_DISTANCE_COUNT_BITS, &count_bits);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    num_distance_codes = count_bits + 1;
+
+    status = this->read_bits(GZIP_READER_NUM_CODE_LENGTH_COUNT_BITS, &count_bits);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    num_code_length_codes = count_bits + GZIP_READER_MIN_NUM_CODE_LENGTH_CODES;
+
+    if ((GZIP_READER_NUM_LITERAL_LENGTH_CODES < num_literal_length_codes) ||
+        (GZIP_READER_NUM_DISTANCE_CODES < num_distance_codes)) {
+        status = PENES_STATUS_GZIP_READER_READ_DYNAMIC_CODES_INVALID_LENGTHS;
+        DEBUG_PRINT_WITH_ARGS("Too many codes. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The code lengths are themselves Huffman coded, with a code whose lengths come first. */
+    for (code_index = 0; code_index < num_code_length_codes; code_index++) {
+        status = this->read_bits(GZIP_READER_CODE_LENGTH_CODE_BITS, &count_bits);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        code_length_code_lengths[gzip_reader_code_length_order[code_index]] = static_cast<std::uint8_t>(count_bits);
+    }
+
+    status = GzipReader::build_code(code_length_code_lengths, GZIP_READER_NUM_CODE_LENGTH_CODES, &code_length_code);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("build_code failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The literal/length and distance code lengths form a single sequence, and repeats may cross between them. */
+    code_index = 0;
+    while (code_index < num_literal_length_codes + num_distance_codes) {
+        status = this->decode_symbol(code_length_code, &symbol);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("decode_symbol failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        if (GZIP_READER_REPEAT_PREVIOUS_SYMBOL > symbol) {
+            code_lengths[code_index] = static_cast<std::uint8_t>(symbol);
+            code_index++;
+            continue;
+        }
+
+        if (GZIP_READER_REPEAT_PREVIOUS_SYMBOL == symbol) {
+            if (0 == code_index) {
+                status = PENES_STATUS_GZIP_READER_READ_DYNAMIC_CODES_INVALID_LENGTHS;
+                DEBUG_PRINT_WITH_ARGS("Repeat with no previous length. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+
+            repeated_length = code_lengths[code_index - 1];
+            status = this->read_bits(2, &repeat_bits);
+            num_repeats = 3 + repeat_bits;
+        } else if (GZIP_READER_REPEAT_ZERO_SYMBOL == symbol) {
+            repeated_length = 0;
+            status = this->read_bits(3, &repeat_bits);
+            num_repeats = 3 + repeat_bits;
+        } else {
+            repeated_length = 0;
+            status = this->read_bits(7, &repeat_bits);
+            num_repeats = 11 + repeat_bits;
+        }
+
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        if (num_literal_length_codes + num_distance_codes < code_index + num_repeats) {
+            status = PENES_STATUS_GZIP_READER_READ_DYNAMIC_CODES_INVALID_LENGTHS;
+            DEBUG_PRINT_WITH_ARGS("Repeat past the last code. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        for (; 0 < num_repeats; num_repeats--) {
+            code_lengths[code_index] = repeated_length;
+            code_index++;
+        }
+    }
+
+    /* Every block ends with the end of block symbol, and so it must have a code. */
+    if (0 == code_lengths[GZIP_READER_END_OF_BLOCK_SYMBOL]) {
+        status = PENES_STATUS_GZIP_READER_READ_DYNAMIC_CODES_INVALID_LENGTHS;
+        DEBUG_PRINT_WITH_ARGS("No end of block code. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = GzipReader::build_code(code_lengths, num_literal_length_codes, &this->dynamic_literal_length_code);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("build_code failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = GzipReader::build_code(
+        &code_lengths[num_literal_length_codes],
+        num_distance_codes,
+        &this->dynamic_distance_code
+    );
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("build_code failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_input_byte(std::uint8_t *output_byte)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != output_byte);
+
+    /* The file is read in large chunks, so that decoding does not issue a read per byte. */
+    if (this->input_buffer_size == this->input_buffer_offset) {
+        this->input_file_stream.read(reinterpret_cast<char *>(this->input_buffer.data()), this->input_buffer.size());
+        this->input_buffer_size = this->input_file_stream.gcount();
+        this->input_buffer_offset = 0;
+
+        if (0 == this->input_buffer_size) {
+            status = PENES_STATUS_GZIP_READER_READ_INPUT_BYTE_TRUNCATED_FILE;
+            DEBUG_PRINT_WITH_ARGS("The compressed data is truncated. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    *output_byte = this->input_buffer[this->input_buffer_offset];
+    this->input_buffer_offset++;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_bits(std::size_t num_bits, std::uint32_t *output_bits)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint8_t input_byte = 0;
+
+    ASSERT(nullptr != output_bits);
+
+    /* Bits are packed starting from the least significant bit of each byte. */
+    while (this->num_buffered_bits < num_bits) {
+        status = this->read_input_byte(&input_byte);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_input_byte failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->bit_buffer |= static_cast<std::uint64_t>(input_byte) << this->num_buffered_bits;
+        this->num_buffered_bits += SYSTEM_NATIVE_WORD_SIZE_BITS;
+    }
+
+    *output_bits = static_cast<std::uint32_t>(this->bit_buffer & ((static_cast<std::uint64_t>(1) << num_bits) - 1));
+    this->bit_buffer >>= num_bits;
+    this->num_buffered_bits -= num_bits;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus GzipReader::read_aligned_byte(std::uint8_t *output_byte)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint32_t byte_bits = 0;
+
+    ASSERT(nullptr != output_byte);
+
+    /* Whole bytes may still be left in the bit buffer from before the alignment. */
+    if (0 < this->num_buffered_bits) {
+        status = this->read_bits(SYSTEM_NATIVE_WORD_SIZE_BITS, &byte_bits);
+        *output_byte = static_cast<std::uint8_t>(byte_bits);
+    } else {
+        status = this->read_input_byte(output_byte);
+    }
+
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("Failed to read a byte. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+template <std::size_t NUM_SYMBOLS>
+enum PeNESStatus GzipReader::decode_symbol(
+    const struct GzipReaderHuffmanCode<NUM_SYMBOLS>& code,
+    std::uint16_t *output_symbol
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint32_t code_bit = 0;
+    std::int32_t code_value = 0;
+    std::int32_t first_code_value = 0;
+    std::int32_t num_codes = 0;
+    std::size_t symbol_index = 0;
+    std::size_t code_length = 0;
+
+    ASSERT(nullptr != output_symbol);
+
+    /* Canonical codes of each length are consecutive, and so the code is matched one length at a time. */
+    for (code_length = 1; code_length <= GZIP_READER_MAX_CODE_LENGTH; code_length++) {
+        status = this->read_bits(1, &code_bit);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_bits failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        code_value |= code_bit;
+        num_codes = code.num_codes_per_length[code_length];
+        if (code_value - num_codes < first_code_value) {
+            *output_symbol = code.symbols[symbol_index + (code_value - first_code_value)];
+
+            status = PENES_STATUS_SUCCESS;
+            goto l_cleanup;
+        }
+
+        symbol_index += num_codes;
+        first_code_value = (first_code_value + num_codes) << 1;
+        code_value <<= 1;
+    }
+
+    status = PENES_STATUS_GZIP_READER_DECODE_SYMBOL_INVALID_CODE;
+    DEBUG_PRINT_WITH_ARGS("Invalid Huffman code. Status: %d.\n", status);
+
+l_cleanup:
+    return status;
+}
+
+
+template <std::size_t NUM_SYMBOLS>
+enum PeNESStatus GzipReader::build_code(
+    const std::uint8_t *code_lengths,
+    std::size_t num_code_lengths,
+    struct GzipReaderHuffmanCode<NUM_SYMBOLS> *output_code
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::array<std::uint16_t, GZIP_READER_MAX_CODE_LENGTH + 1> symbol_offsets = {};
+    std::int32_t num_unused_codes = 1;
+    std::size_t code_length = 0;
+    std::size_t symbol = 0;
+
+    ASSERT(nullptr != code_lengths);
+    ASSERT(nullptr != output_code);
+    ASSERT(NUM_SYMBOLS >= num_code_lengths);
+
+    output_code->num_codes_per_length.fill(0);
+    for (symbol = 0; symbol < num_code_lengths; symbol++) {
+        output_code->num_codes_per_length[code_lengths[symbol]]++;
+    }
+
+    /* Verify that there are not more codes of some length than the shorter codes leave room for.
+     * Incomplete codes are allowed, since an unused code simply fails to decode.
+     * */
+    for (code_length = 1; code_length <= GZIP_READER_MAX_CODE_LENGTH; code_length++) {
+        num_unused_codes = (num_unused_codes << 1) - output_code->num_codes_per_length[code_length];
+        if (0 > num_unused_codes) {
+            status = PENES_STATUS_GZIP_READER_BUILD_CODE_OVERSUBSCRIBED;
+            DEBUG_PRINT_WITH_ARGS("Over-subscribed code. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    /* Sort the symbols by code length, and by value within each length. */
+    for (code_length = 1; code_length < GZIP_READER_MAX_CODE_LENGTH; code_length++) {
+        symbol_offsets[code_length + 1] = symbol_offsets[code_length] + output_code->num_codes_per_length[code_length];
+    }
+
+    for (symbol = 0; symbol < num_code_lengths; symbol++) {
+        if (0 != code_lengths[symbol]) {
+            output_code->symbols[symbol_offsets[code_lengths[symbol]]] = static_cast<std::uint16_t>(symbol);
+            symbol_offsets[code_lengths[symbol]]++;
+        }
+    }
+
+    /* Lengths of 0 mark unused symbols, and so they are not codes. */
+    output_code->num_codes_per_length[0] = 0;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
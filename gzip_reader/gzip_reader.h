@@ -0,0 +1,158 @@
+/**
+ * @brief  Streaming reader of gzip compressed files, with a self-contained inflate implementation.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __GZIP_READER_H__
+#define __GZIP_READER_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "penes_status.h"
+#include "system.h"
+
+/** Constants *************************************************************/
+#define GZIP_READER_MAGIC_SIZE (2)
+#define GZIP_READER_WINDOW_SIZE (0x8000)
+#define GZIP_READER_INPUT_BUFFER_SIZE (0x10000)
+#define GZIP_READER_MAX_CODE_LENGTH (15)
+#define GZIP_READER_NUM_LITERAL_LENGTH_CODES (288)
+#define GZIP_READER_NUM_DISTANCE_CODES (30)
+#define GZIP_READER_NUM_CODE_LENGTH_CODES (19)
+
+/** Enums *****************************************************************/
+enum GzipReaderBlockType {
+    GZIP_READER_BLOCK_TYPE_NONE = -1,
+    GZIP_READER_BLOCK_TYPE_STORED = 0,
+    GZIP_READER_BLOCK_TYPE_FIXED_HUFFMAN,
+    GZIP_READER_BLOCK_TYPE_DYNAMIC_HUFFMAN,
+    GZIP_READER_BLOCK_TYPE_INVALID
+};
+
+/** Structs ***************************************************************/
+/** @brief A canonical Huffman code, stored as the number of codes of each length and the symbols sorted by code. */
+template <std::size_t NUM_SYMBOLS>
+struct GzipReaderHuffmanCode {
+    std::array<std::uint16_t, GZIP_READER_MAX_CODE_LENGTH + 1> num_codes_per_length;
+    std::array<std::uint16_t, NUM_SYMBOLS> symbols;
+};
+
+/** Typedefs **************************************************************/
+typedef struct GzipReaderHuffmanCode<GZIP_READER_NUM_LITERAL_LENGTH_CODES> gzip_reader_literal_length_code_t;
+typedef struct GzipReaderHuffmanCode<GZIP_READER_NUM_DISTANCE_CODES> gzip_reader_distance_code_t;
+
+/** Classes ***************************************************************/
+class GzipReader {
+public:
+    /** @brief          Open a gzip file and parse its member header.
+     *
+     *  @param[in]      input_file                  The path of the file.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Only the first member of multi-member files is read.
+     * */
+    enum PeNESStatus open(const std::string& input_file);
+
+    /** @brief          Decompress the next bytes of the file.
+     *                  Bytes are decompressed straight into the buffer, without an intermediate copy
+     *                  other than the sliding window referenced by back-references.
+     *
+     *  @param[out]     output_buffer               The buffer to decompress into.
+     *  @param[in]      num_bytes                   The number of bytes to decompress.
+     *  @param[out]     output_num_read             The number of decompressed bytes,
+     *                                              which is only less than num_bytes at the end of the data.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus read(native_word_t *output_buffer, std::size_t num_bytes, std::size_t *output_num_read);
+
+    /** @brief          Decompress and discard the rest of the data, and verify it against the member trailer.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus finish();
+
+    /** @brief Check whether a file starts with the gzip magic. */
+    static bool is_gzip_file(const std::string& input_file);
+
+    /** @brief          Retrieve the decompressed size of a gzip file from its trailer, without decompressing it.
+     *
+     *  @param[in]      input_file                  The path of the file.
+     *  @param[out]     output_size                 The decompressed size, modulo 2^32 as stored by gzip.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           The size is only verified once the data has been decompressed, see finish.
+     *                  Until then, it is only known not to exceed what the compressed data can expand to.
+     * */
+    static enum PeNESStatus get_decompressed_size(const std::string& input_file, std::size_t *output_size);
+
+private:
+    enum PeNESStatus read_member_header();
+
+    enum PeNESStatus read_block_header();
+
+    enum PeNESStatus read_dynamic_codes();
+
+    enum PeNESStatus read_input_byte(std::uint8_t *output_byte);
+
+    enum PeNESStatus read_bits(std::size_t num_bits, std::uint32_t *output_bits);
+
+    enum PeNESStatus read_aligned_byte(std::uint8_t *output_byte);
+
+    template <std::size_t NUM_SYMBOLS>
+    enum PeNESStatus decode_symbol(const struct GzipReaderHuffmanCode<NUM_SYMBOLS>& code, std::uint16_t *output_symbol);
+
+    template <std::size_t NUM_SYMBOLS>
+    static enum PeNESStatus build_code(
+        const std::uint8_t *code_lengths,
+        std::size_t num_code_lengths,
+        struct GzipReaderHuffmanCode<NUM_SYMBOLS> *output_code
+    );
+
+    /** @brief Discard the bits left of the current byte, as stored blocks and the trailer are byte aligned. */
+    inline void align_to_byte()
+    {
+        this->bit_buffer >>= this->num_buffered_bits % SYSTEM_NATIVE_WORD_SIZE_BITS;
+        this->num_buffered_bits -= this->num_buffered_bits % SYSTEM_NATIVE_WORD_SIZE_BITS;
+    }
+
+    inline void emit_byte(native_word_t *output_buffer, native_word_t output_byte)
+    {
+        *output_buffer = output_byte;
+        this->window[this->total_output_size % GZIP_READER_WINDOW_SIZE] = output_byte;
+        this->total_output_size++;
+    }
+
+    std::ifstream input_file_stream;
+    std::array<std::uint8_t, GZIP_READER_INPUT_BUFFER_SIZE> input_buffer;
+    std::size_t input_buffer_offset = 0;
+    std::size_t input_buffer_size = 0;
+    std::uint64_t bit_buffer = 0;
+    std::size_t num_buffered_bits = 0;
+
+    std::array<native_word_t, GZIP_READER_WINDOW_SIZE> window;
+    std::uint64_t total_output_size = 0;
+    std::uint32_t output_crc32 = 0;
+
+    enum GzipReaderBlockType block_type = GZIP_READER_BLOCK_TYPE_NONE;
+    bool is_final_block = false;
+    bool is_end_of_data = false;
+    std::size_t stored_block_remaining_size = 0;
+    std::size_t match_remaining_length = 0;
+    std::size_t match_distance = 0;
+    gzip_reader_literal_length_code_t dynamic_literal_length_code;
+    gzip_reader_distance_code_t dynamic_distance_code;
+    const gzip_reader_literal_length_code_t *literal_length_code = nullptr;
+    const gzip_reader_distance_code_t *distance_code = nullptr;
+};
+
+
+#endif /* __GZIP_READER_H__ */
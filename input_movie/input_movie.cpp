@@ -0,0 +1,115 @@
+/**
+ * @brief  Input movies, recording the buttons held on the controllers at every frame.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "input_movie/input_movie.h"
+
+/** Constants *************************************************************/
+#define INPUT_MOVIE_FIELD_SEPARATOR ('|')
+#define INPUT_MOVIE_RELEASED_BUTTON ('.')
+#define INPUT_MOVIE_RELEASED_BUTTON_ALTERNATE (' ')
+#define INPUT_MOVIE_GAMEPAD_NUM_BUTTONS (8)
+/* A frame line starts with a separator, and so its first field is empty, followed by the commands and then the ports. */
+#define INPUT_MOVIE_FIRST_PORT_FIELD_INDEX (2)
+
+/** Functions *************************************************************/
+enum PeNESStatus InputMovie::load(const std::string& movie_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ifstream movie_stream;
+    std::string line;
+    std::string field;
+    std::size_t field_index = 0;
+    std::array<native_word_t, STANDARD_CONTROLLER_NUM_PORTS> buttons = {};
+
+    movie_stream.open(movie_file);
+    if (true == movie_stream.fail()) {
+        status = PENES_STATUS_INPUT_MOVIE_LOAD_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the movie file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->frame_buttons.clear();
+
+    while (true == static_cast<bool>(std::getline(movie_stream, line))) {
+        if ((true == line.empty()) || (INPUT_MOVIE_FIELD_SEPARATOR != line[0])) {
+            continue;
+        }
+
+        std::istringstream line_stream(line);
+        buttons.fill(STANDARD_CONTROLLER_BUTTON_NONE);
+
+        /* Fields past the ports, such as the expansion port, are ignored. */
+        for (field_index = 0; field_index < INPUT_MOVIE_FIRST_PORT_FIELD_INDEX + STANDARD_CONTROLLER_NUM_PORTS; field_index++) {
+            if (false == static_cast<bool>(std::getline(line_stream, field, INPUT_MOVIE_FIELD_SEPARATOR))) {
+                break;
+            }
+
+            if (INPUT_MOVIE_FIRST_PORT_FIELD_INDEX > field_index) {
+                continue;
+            }
+
+            status = InputMovie::parse_gamepad(field, &buttons[field_index - INPUT_MOVIE_FIRST_PORT_FIELD_INDEX]);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("parse_gamepad failed. Status: %d. Frame: %zu.\n", status, this->frame_buttons.size());
+                goto l_cleanup;
+            }
+        }
+
+        this->frame_buttons.push_back(buttons);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus InputMovie::parse_gamepad(const std::string& gamepad_field, native_word_t *output_buttons)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    native_word_t buttons = STANDARD_CONTROLLER_BUTTON_NONE;
+    std::size_t button_index = 0;
+
+    ASSERT(nullptr != output_buttons);
+
+    /* A port without a controller has an empty field. */
+    if (true == gamepad_field.empty()) {
+        *output_buttons = STANDARD_CONTROLLER_BUTTON_NONE;
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    if (INPUT_MOVIE_GAMEPAD_NUM_BUTTONS != gamepad_field.size()) {
+        status = PENES_STATUS_INPUT_MOVIE_PARSE_GAMEPAD_INVALID_FIELD;
+        DEBUG_PRINT_WITH_ARGS("Invalid gamepad field. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The buttons are listed from Right to A, the reverse of the order they are shifted out. */
+    for (button_index = 0; button_index < INPUT_MOVIE_GAMEPAD_NUM_BUTTONS; button_index++) {
+        if ((INPUT_MOVIE_RELEASED_BUTTON != gamepad_field[button_index]) &&
+            (INPUT_MOVIE_RELEASED_BUTTON_ALTERNATE != gamepad_field[button_index])) {
+            buttons |= 1 << (INPUT_MOVIE_GAMEPAD_NUM_BUTTONS - 1 - button_index);
+        }
+    }
+
+    *output_buttons = buttons;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
@@ -0,0 +1,68 @@
+/**
+ * @brief  Input movies, recording the buttons held on the controllers at every frame.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __INPUT_MOVIE_H__
+#define __INPUT_MOVIE_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "controller/standard_controller.h"
+
+/** Classes ***************************************************************/
+/** @brief An input movie in the FCEUX text format (.fm2).
+ *         Only the input log is used: every line starting with '|' is a frame,
+ *         holding the commands and then the buttons of each port as "RLDUTSBA",
+ *         where any character other than '.' or ' ' marks a held button.
+ *         Header lines and the reset commands are ignored.
+ * */
+class InputMovie {
+public:
+    /** @brief          Load the frames of a movie file.
+     *
+     *  @param[in]      movie_file                  The path of the movie file.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus load(const std::string& movie_file);
+
+    /** @brief          Retrieve the buttons held on a controller at a frame.
+     *
+     *  @param[in]      frame_index                 The index of the frame.
+     *  @param[in]      port_index                  The index of the port the controller is plugged into.
+     *
+     *  @return         A mask of StandardControllerButton values, with no buttons held past the end of the movie.
+     * */
+    inline native_word_t get_buttons(std::size_t frame_index, std::size_t port_index) const
+    {
+        ASSERT(STANDARD_CONTROLLER_NUM_PORTS > port_index);
+
+        if (this->frame_buttons.size() <= frame_index) {
+            return STANDARD_CONTROLLER_BUTTON_NONE;
+        }
+
+        return this->frame_buttons[frame_index][port_index];
+    }
+
+    inline std::size_t get_num_frames() const
+    {
+        return this->frame_buttons.size();
+    }
+
+private:
+    static enum PeNESStatus parse_gamepad(const std::string& gamepad_field, native_word_t *output_buttons);
+
+    std::vector<std::array<native_word_t, STANDARD_CONTROLLER_NUM_PORTS>> frame_buttons;
+};
+
+#endif /* __INPUT_MOVIE_H__ */
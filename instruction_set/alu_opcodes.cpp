@@ -16,6 +16,16 @@
 
 #include "instruction_set/alu_opcodes.h"
 
+/** Constants *************************************************************/
+#define ALU_OPCODES_LOW_DIGIT_MASK (0x0F)
+#define ALU_OPCODES_HIGH_DIGIT_MASK (0xF0)
+#define ALU_OPCODES_LOW_DIGIT_LIMIT (0x0A)
+#define ALU_OPCODES_HIGH_DIGIT_LIMIT (0xA0)
+#define ALU_OPCODES_LOW_DIGIT_ADJUST (0x06)
+#define ALU_OPCODES_HIGH_DIGIT_ADJUST (0x60)
+#define ALU_OPCODES_LOW_DIGIT_CARRY (0x10)
+#define ALU_OPCODES_WORD_CARRY (0x100)
+
 /** Namespaces ************************************************************/
 using namespace instruction_set;
 
@@ -78,6 +88,104 @@ enum PeNESStatus IAddOpcode::add(
         goto l_cleanup;
     }
 
+    /* The 2A03 has no decimal mode, and so this check is compiled out of the NES build. */
+    if ((true == system_cpu_variant_t::has_decimal_mode) &&
+        (0 != (register_status_data & REGISTER_STATUS_FLAG_MASK_DECIMAL))) {
+        status = this->adjust_decimal(program_ctx, register_a_data, add_operand, is_carry_set, is_borrow);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("adjust_decimal failed. Status: %d", status);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus IAddOpcode::adjust_decimal(
+    ProgramContext *program_ctx,
+    native_word_t register_a_data,
+    native_word_t add_operand,
+    bool is_carry_set,
+    bool is_borrow
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    RegisterStorage<native_word_t> *register_a = nullptr;
+    RegisterStorage<native_word_t> *register_status = nullptr;
+    int operand_data = 0;
+    int low_digit_result = 0;
+    int operation_result = 0;
+    native_word_t update_values = 0;
+
+    ASSERT(nullptr != program_ctx);
+
+    register_a = program_ctx->register_file.get_register_a();
+    register_status = program_ctx->register_file.get_register_status();
+
+    if (true == is_borrow) {
+        /* Subtract digit by digit, borrowing 6 from any digit that went below zero.
+         * The operand was complemented for the binary subtraction, and so it is complemented back.
+         * */
+        operand_data = static_cast<native_word_t>(~add_operand);
+        low_digit_result = (register_a_data & ALU_OPCODES_LOW_DIGIT_MASK) - (operand_data & ALU_OPCODES_LOW_DIGIT_MASK) +
+                           ((true == is_carry_set)? 1: 0) - 1;
+        if (0 > low_digit_result) {
+            low_digit_result = ((low_digit_result - ALU_OPCODES_LOW_DIGIT_ADJUST) & ALU_OPCODES_LOW_DIGIT_MASK) -
+                               ALU_OPCODES_LOW_DIGIT_CARRY;
+        }
+
+        operation_result = (register_a_data & ALU_OPCODES_HIGH_DIGIT_MASK) - (operand_data & ALU_OPCODES_HIGH_DIGIT_MASK) +
+                           low_digit_result;
+        if (0 > operation_result) {
+            operation_result -= ALU_OPCODES_HIGH_DIGIT_ADJUST;
+        }
+
+        register_a->write(static_cast<native_word_t>(operation_result));
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* Add digit by digit, adding 6 to any digit that went past 9 so that it carries into the next digit. */
+    low_digit_result = (register_a_data & ALU_OPCODES_LOW_DIGIT_MASK) + (add_operand & ALU_OPCODES_LOW_DIGIT_MASK) +
+                       ((true == is_carry_set)? 1: 0);
+    if (ALU_OPCODES_LOW_DIGIT_LIMIT <= low_digit_result) {
+        low_digit_result = ((low_digit_result + ALU_OPCODES_LOW_DIGIT_ADJUST) & ALU_OPCODES_LOW_DIGIT_MASK) +
+                           ALU_OPCODES_LOW_DIGIT_CARRY;
+    }
+
+    operation_result = (register_a_data & ALU_OPCODES_HIGH_DIGIT_MASK) + (add_operand & ALU_OPCODES_HIGH_DIGIT_MASK) +
+                       low_digit_result;
+
+    /* The Negative and Overflow flags are taken before the high digit is corrected, and the Zero flag is left binary. */
+    update_values = register_status->read() & REGISTER_STATUS_FLAG_MASK_ZERO;
+    if (0 != (operation_result & SYSTEM_NATIVE_WORD_SIGN_BIT_MASK)) {
+        update_values |= REGISTER_STATUS_FLAG_MASK_NEGATIVE;
+    }
+
+    if (0 != ((register_a_data ^ operation_result) & (add_operand ^ operation_result) & SYSTEM_NATIVE_WORD_SIGN_BIT_MASK)) {
+        update_values |= REGISTER_STATUS_FLAG_MASK_OVERFLOW;
+    }
+
+    if (ALU_OPCODES_HIGH_DIGIT_LIMIT <= operation_result) {
+        operation_result += ALU_OPCODES_HIGH_DIGIT_ADJUST;
+    }
+
+    if (ALU_OPCODES_WORD_CARRY <= operation_result) {
+        update_values |= REGISTER_STATUS_FLAG_MASK_CARRY;
+    }
+
+    register_a->write(static_cast<native_word_t>(operation_result));
+
+    status = this->update_status(register_status, update_values);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Superclass update_status failed. Status: %d", status);
+        goto l_cleanup;
+    }
+
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
     return status;
@@ -48,6 +48,28 @@ protected:
         native_word_t add_operand,
         bool is_borrow = false
     );
+
+private:
+    /** @brief          Correct the binary result of an addition in decimal mode, as done by the NMOS 6502.
+     *                  Only used by CPU variants with a decimal mode.
+     *
+     *  @param[in]      program_ctx                 The program context containing the Accumulator to correct.
+     *  @param[in]      register_a_data             The Accumulator before the addition.
+     *  @param[in]      add_operand                 The WORD of data that was added.
+     *  @param[in]      is_carry_set                Was the Carry flag set before the addition?
+     *  @param[in]      is_borrow                   Was the addition a subtraction, with add_operand complemented?
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           As on the NMOS 6502, the Zero flag of ADC and all flags of SBC keep their binary values.
+     * */
+    enum PeNESStatus adjust_decimal(
+        ProgramContext *program_ctx,
+        native_word_t register_a_data,
+        native_word_t add_operand,
+        bool is_carry_set,
+        bool is_borrow
+    );
 };
 
 /** @brief Add data to Accumulator with Carry. */
@@ -60,6 +60,12 @@ enum PeNESStatus IBranchOpcode::branch(
     /* Add the relative offset to the program counter. */
     register_program_counter->write(absolute_branch_address);
 
+    /* A taken branch takes an extra cycle, and another one when it lands on a different page. */
+    program_ctx->num_branch_cycles += BRANCH_OPCODES_TAKEN_BRANCH_CYCLES;
+    if (MEMORY_MAP_ADDRESS_TO_PAGE(absolute_branch_address) != MEMORY_MAP_ADDRESS_TO_PAGE(register_program_counter_data)) {
+        program_ctx->num_branch_cycles += BRANCH_OPCODES_PAGE_CROSS_CYCLES;
+    }
+
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
     return status;
@@ -16,6 +16,10 @@
 #include "storage_location/storage_location.h"
 #include "instruction_set/opcode_interface.h"
 
+/** Constants *************************************************************/
+#define BRANCH_OPCODES_TAKEN_BRANCH_CYCLES (1)
+#define BRANCH_OPCODES_PAGE_CROSS_CYCLES (1)
+
 /** Namespaces ************************************************************/
 namespace instruction_set {
 
@@ -29,61 +29,61 @@ using namespace instruction_set;
 /** Static Variables ******************************************************/
 const utils::InstanceFactoryList<enum OpcodeType, IOpcode> OpcodeTable::opcode_instance_factory_list = {
     nullptr,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeADC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeAND>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeASL>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBCC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBCS>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBEQ>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBIT>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBMI>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBNE>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBPL>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBRK>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBVC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeBVS>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCLC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCLD>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCLI>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCLV>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCMP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCPX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeCPY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeDEC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeDEX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeDEY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeEOR>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeINC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeINX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeINY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeJMP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeIndirectJMP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeJSR>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeLDA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeLDX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeLDY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeLSR>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeNOP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeORA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodePHA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodePHP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodePLA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodePLP>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeROL>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeROR>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeRTI>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeRTS>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSBC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSEC>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSED>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSEI>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSTA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSTX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeSTY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTAX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTAY>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTSX>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTXA>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTXS>,
-    utils::SubClassFactory<IOpcode>::create_instance<OpcodeTYA>
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeADC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeAND>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeASL>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBCC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBCS>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBEQ>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBIT>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBMI>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBNE>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBPL>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBRK>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBVC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeBVS>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCLC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCLD>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCLI>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCLV>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCMP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCPX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeCPY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeDEC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeDEX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeDEY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeEOR>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeINC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeINX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeINY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeJMP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeIndirectJMP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeJSR>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeLDA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeLDX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeLDY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeLSR>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeNOP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeORA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodePHA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodePHP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodePLA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodePLP>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeROL>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeROR>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeRTI>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeRTS>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSBC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSEC>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSED>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSEI>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSTA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSTX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeSTY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTAX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTAY>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTSX>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTXA>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTXS>,
+    utils::SubClassFactory<IOpcode>::get_shared_instance<OpcodeTYA>
 };
\ No newline at end of file
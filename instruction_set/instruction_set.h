@@ -115,13 +115,15 @@ public:
         IOpcode *instruction_opcode,
         address_mode::IAddressMode *instruction_address_mode = nullptr,
         IStorageLocation *operand_storage = nullptr,
-        std::size_t operand_storage_offset = 0
+        std::size_t operand_storage_offset = 0,
+        native_word_t opcode_data = 0
     ):
         program_ctx(program_ctx),
         instruction_opcode(instruction_opcode),
         instruction_address_mode(instruction_address_mode),
         operand_storage(operand_storage),
-        operand_storage_offset(operand_storage_offset)
+        operand_storage_offset(operand_storage_offset),
+        opcode_data(opcode_data)
     {
         ASSERT(nullptr != program_ctx);
         ASSERT(nullptr != instruction_opcode);
@@ -159,12 +161,19 @@ public:
         return status;
     }
 
+    /** @brief Retrieve the encoded opcode byte, which indexes the instruction timing tables. */
+    inline native_word_t get_opcode_data() const
+    {
+        return this->opcode_data;
+    }
+
 private:
     ProgramContext *program_ctx;
     IOpcode *instruction_opcode;
     address_mode::IAddressMode *instruction_address_mode;
     IStorageLocation *operand_storage;
     std::size_t operand_storage_offset;
+    native_word_t opcode_data;
 };
 
 }
@@ -91,6 +91,9 @@ protected:
             goto l_cleanup;
         }
 
+        /* CLI, PLP and RTI may clear the Interrupt Disable flag, which lets an IRQ held while it was set through. */
+        program_ctx->release_masked_irq();
+
         status = PENES_STATUS_SUCCESS;
     l_cleanup:
         return status;
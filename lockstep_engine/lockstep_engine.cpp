@@ -0,0 +1,1127 @@
+/**
+ * @brief  Lockstep execution of many machines, which runs together the lanes that are at the same instruction.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <algorithm>
+#include <array>
+#include <ostream>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "decoder/decoder.h"
+#include "instruction_set/instruction_set.h"
+#include "lockstep_engine/lockstep_engine.h"
+
+/** Constants *************************************************************/
+/* The number of lanes whose registers a single vector holds, a byte each. */
+#if defined(__AVX2__)
+#define LOCKSTEP_ENGINE_LANES_PER_VECTOR (32)
+#elif defined(__SSE2__)
+#define LOCKSTEP_ENGINE_LANES_PER_VECTOR (16)
+#else
+#define LOCKSTEP_ENGINE_LANES_PER_VECTOR (1)
+#endif
+
+#define LOCKSTEP_ENGINE_LANE_MASK_SET (0xFF)
+
+/** Typedefs **************************************************************/
+#if defined(__AVX2__)
+typedef __m256i lane_vector_t;
+#elif defined(__SSE2__)
+typedef __m128i lane_vector_t;
+#else
+typedef native_word_t lane_vector_t;
+#endif
+
+/** Functions *************************************************************/
+/* The vector operations on the registers of LOCKSTEP_ENGINE_LANES_PER_VECTOR lanes.
+ * Without a vector instruction set, a vector is the register of a single lane.
+ * */
+static inline lane_vector_t lane_vector_load(const native_word_t *lanes)
+{
+#if defined(__AVX2__)
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(lanes));
+#elif defined(__SSE2__)
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(lanes));
+#else
+    return *lanes;
+#endif
+}
+
+
+static inline void lane_vector_store(native_word_t *lanes, lane_vector_t vector)
+{
+#if defined(__AVX2__)
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), vector);
+#elif defined(__SSE2__)
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), vector);
+#else
+    *lanes = vector;
+#endif
+}
+
+
+static inline lane_vector_t lane_vector_set(native_word_t value)
+{
+#if defined(__AVX2__)
+    return _mm256_set1_epi8(static_cast<char>(value));
+#elif defined(__SSE2__)
+    return _mm_set1_epi8(static_cast<char>(value));
+#else
+    return value;
+#endif
+}
+
+
+static inline lane_vector_t lane_vector_and(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_and_si256(left, right);
+#elif defined(__SSE2__)
+    return _mm_and_si128(left, right);
+#else
+    return left & right;
+#endif
+}
+
+
+/** @brief Clear the bits of a vector that are set in a mask. */
+static inline lane_vector_t lane_vector_clear(lane_vector_t vector, lane_vector_t mask)
+{
+#if defined(__AVX2__)
+    return _mm256_andnot_si256(mask, vector);
+#elif defined(__SSE2__)
+    return _mm_andnot_si128(mask, vector);
+#else
+    return vector & static_cast<native_word_t>(~mask);
+#endif
+}
+
+
+static inline lane_vector_t lane_vector_or(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_or_si256(left, right);
+#elif defined(__SSE2__)
+    return _mm_or_si128(left, right);
+#else
+    return left | right;
+#endif
+}
+
+
+static inline lane_vector_t lane_vector_xor(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_xor_si256(left, right);
+#elif defined(__SSE2__)
+    return _mm_xor_si128(left, right);
+#else
+    return left ^ right;
+#endif
+}
+
+
+/** @brief Add the lanes of two vectors, wrapping around within the word as the registers do. */
+static inline lane_vector_t lane_vector_add(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_add_epi8(left, right);
+#elif defined(__SSE2__)
+    return _mm_add_epi8(left, right);
+#else
+    return static_cast<native_word_t>(left + right);
+#endif
+}
+
+
+/** @brief Subtract the lanes of two vectors, wrapping around within the word as the registers do. */
+static inline lane_vector_t lane_vector_sub(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_sub_epi8(left, right);
+#elif defined(__SSE2__)
+    return _mm_sub_epi8(left, right);
+#else
+    return static_cast<native_word_t>(left - right);
+#endif
+}
+
+
+/** @brief Compare the lanes of two vectors, into all ones for the equal lanes and zero for the others. */
+static inline lane_vector_t lane_vector_equal(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_cmpeq_epi8(left, right);
+#elif defined(__SSE2__)
+    return _mm_cmpeq_epi8(left, right);
+#else
+    return (left == right)? LOCKSTEP_ENGINE_LANE_MASK_SET: 0;
+#endif
+}
+
+
+/** @brief Compare the lanes of two vectors as unsigned words, into all ones for the lanes where left >= right. */
+static inline lane_vector_t lane_vector_greater_equal(lane_vector_t left, lane_vector_t right)
+{
+#if defined(__AVX2__)
+    return _mm256_cmpeq_epi8(_mm256_max_epu8(left, right), left);
+#elif defined(__SSE2__)
+    return _mm_cmpeq_epi8(_mm_max_epu8(left, right), left);
+#else
+    return (left >= right)? LOCKSTEP_ENGINE_LANE_MASK_SET: 0;
+#endif
+}
+
+
+/** @brief Select the lanes of one vector where a mask is all ones, and the lanes of another where it is zero. */
+static inline lane_vector_t lane_vector_select(lane_vector_t mask, lane_vector_t selected, lane_vector_t other)
+{
+#if defined(__AVX2__)
+    return _mm256_blendv_epi8(other, selected, mask);
+#elif defined(__SSE4_1__)
+    return _mm_blendv_epi8(other, selected, mask);
+#elif defined(__SSE2__)
+    /* The mask is all ones or zero in every lane, and so a bitwise select is a blend. */
+    return _mm_or_si128(_mm_and_si128(mask, selected), _mm_andnot_si128(mask, other));
+#else
+    return (0 != mask)? selected: other;
+#endif
+}
+
+
+static inline bool lane_vector_is_zero(lane_vector_t vector)
+{
+#if defined(__AVX2__)
+    return 0 != _mm256_testz_si256(vector, vector);
+#elif defined(__SSE4_1__)
+    return 0 != _mm_testz_si128(vector, vector);
+#elif defined(__SSE2__)
+    return 0xFFFF == _mm_movemask_epi8(_mm_cmpeq_epi8(vector, _mm_setzero_si128()));
+#else
+    return 0 == vector;
+#endif
+}
+
+
+/** @brief Retrieve the Negative and Zero status flags of the results of an operation, see update_data_status. */
+static inline lane_vector_t lane_vector_data_status(lane_vector_t result)
+{
+    return lane_vector_or(
+        lane_vector_and(result, lane_vector_set(REGISTER_STATUS_FLAG_MASK_NEGATIVE)),
+        lane_vector_and(lane_vector_equal(result, lane_vector_set(0)), lane_vector_set(REGISTER_STATUS_FLAG_MASK_ZERO))
+    );
+}
+
+
+/** @brief Retrieve the operation the engine runs an opcode with, or LOCKSTEP_ENGINE_OPERATION_SCALAR for none. */
+static enum LockstepEngineOperation get_opcode_operation(enum instruction_set::OpcodeType opcode_type)
+{
+    switch (opcode_type) {
+    case instruction_set::OPCODE_TYPE_LDA: return LOCKSTEP_ENGINE_OPERATION_LDA;
+    case instruction_set::OPCODE_TYPE_LDX: return LOCKSTEP_ENGINE_OPERATION_LDX;
+    case instruction_set::OPCODE_TYPE_LDY: return LOCKSTEP_ENGINE_OPERATION_LDY;
+    case instruction_set::OPCODE_TYPE_STA: return LOCKSTEP_ENGINE_OPERATION_STA;
+    case instruction_set::OPCODE_TYPE_STX: return LOCKSTEP_ENGINE_OPERATION_STX;
+    case instruction_set::OPCODE_TYPE_STY: return LOCKSTEP_ENGINE_OPERATION_STY;
+    case instruction_set::OPCODE_TYPE_AND: return LOCKSTEP_ENGINE_OPERATION_AND;
+    case instruction_set::OPCODE_TYPE_ORA: return LOCKSTEP_ENGINE_OPERATION_ORA;
+    case instruction_set::OPCODE_TYPE_EOR: return LOCKSTEP_ENGINE_OPERATION_EOR;
+    case instruction_set::OPCODE_TYPE_ADC: return LOCKSTEP_ENGINE_OPERATION_ADC;
+    case instruction_set::OPCODE_TYPE_SBC: return LOCKSTEP_ENGINE_OPERATION_SBC;
+    case instruction_set::OPCODE_TYPE_CMP: return LOCKSTEP_ENGINE_OPERATION_CMP;
+    case instruction_set::OPCODE_TYPE_CPX: return LOCKSTEP_ENGINE_OPERATION_CPX;
+    case instruction_set::OPCODE_TYPE_CPY: return LOCKSTEP_ENGINE_OPERATION_CPY;
+    case instruction_set::OPCODE_TYPE_INC: return LOCKSTEP_ENGINE_OPERATION_INC;
+    case instruction_set::OPCODE_TYPE_DEC: return LOCKSTEP_ENGINE_OPERATION_DEC;
+    case instruction_set::OPCODE_TYPE_INX: return LOCKSTEP_ENGINE_OPERATION_INX;
+    case instruction_set::OPCODE_TYPE_INY: return LOCKSTEP_ENGINE_OPERATION_INY;
+    case instruction_set::OPCODE_TYPE_DEX: return LOCKSTEP_ENGINE_OPERATION_DEX;
+    case instruction_set::OPCODE_TYPE_DEY: return LOCKSTEP_ENGINE_OPERATION_DEY;
+    case instruction_set::OPCODE_TYPE_TAX: return LOCKSTEP_ENGINE_OPERATION_TAX;
+    case instruction_set::OPCODE_TYPE_TAY: return LOCKSTEP_ENGINE_OPERATION_TAY;
+    case instruction_set::OPCODE_TYPE_TXA: return LOCKSTEP_ENGINE_OPERATION_TXA;
+    case instruction_set::OPCODE_TYPE_TYA: return LOCKSTEP_ENGINE_OPERATION_TYA;
+    case instruction_set::OPCODE_TYPE_CLC: return LOCKSTEP_ENGINE_OPERATION_CLC;
+    case instruction_set::OPCODE_TYPE_SEC: return LOCKSTEP_ENGINE_OPERATION_SEC;
+    case instruction_set::OPCODE_TYPE_CLI: return LOCKSTEP_ENGINE_OPERATION_CLI;
+    case instruction_set::OPCODE_TYPE_SEI: return LOCKSTEP_ENGINE_OPERATION_SEI;
+    case instruction_set::OPCODE_TYPE_CLD: return LOCKSTEP_ENGINE_OPERATION_CLD;
+    case instruction_set::OPCODE_TYPE_SED: return LOCKSTEP_ENGINE_OPERATION_SED;
+    case instruction_set::OPCODE_TYPE_CLV: return LOCKSTEP_ENGINE_OPERATION_CLV;
+    case instruction_set::OPCODE_TYPE_NOP: return LOCKSTEP_ENGINE_OPERATION_NOP;
+    default: return LOCKSTEP_ENGINE_OPERATION_SCALAR;
+    }
+}
+
+
+const std::array<enum LockstepEngineOperation, CPU_NUM_OPCODES>& LockstepEngine::get_operation_table()
+{
+    /* Function-local statics are initialized once, even when the first engines are created concurrently. */
+    static const std::array<enum LockstepEngineOperation, CPU_NUM_OPCODES> operation_table = []() {
+        std::array<enum LockstepEngineOperation, CPU_NUM_OPCODES> built_table;
+        enum instruction_set::OpcodeType opcode_type = instruction_set::OPCODE_TYPE_NONE;
+        std::size_t opcode_data = 0;
+
+        built_table.fill(LOCKSTEP_ENGINE_OPERATION_SCALAR);
+
+        for (opcode_data = 0; opcode_data < built_table.size(); opcode_data++) {
+            if (PENES_STATUS_SUCCESS == Decoder::get_opcode_type(static_cast<native_word_t>(opcode_data), &opcode_type)) {
+                built_table[opcode_data] = get_opcode_operation(opcode_type);
+            }
+        }
+
+        return built_table;
+    }();
+
+    return operation_table;
+}
+
+
+void LockstepEngine::add_lane(CPU *lane_cpu)
+{
+    ASSERT(nullptr != lane_cpu);
+
+    this->lane_cpus.push_back(lane_cpu);
+    this->lane_target_cycles.push_back(0);
+
+    this->resize_lanes();
+}
+
+
+void LockstepEngine::remove_lane(CPU *lane_cpu)
+{
+    std::vector<CPU *>::iterator lane_iter;
+
+    ASSERT(nullptr != lane_cpu);
+
+    lane_iter = std::find(this->lane_cpus.begin(), this->lane_cpus.end(), lane_cpu);
+    ASSERT(this->lane_cpus.end() != lane_iter);
+
+    this->lane_target_cycles.erase(this->lane_target_cycles.begin() + (lane_iter - this->lane_cpus.begin()));
+    this->lane_cpus.erase(lane_iter);
+
+    this->resize_lanes();
+}
+
+
+void LockstepEngine::resize_lanes()
+{
+    std::size_t num_lanes = this->lane_cpus.size();
+    std::size_t num_padded_lanes = (
+        (num_lanes + LOCKSTEP_ENGINE_LANE_PADDING - 1) / LOCKSTEP_ENGINE_LANE_PADDING
+    ) * LOCKSTEP_ENGINE_LANE_PADDING;
+
+    /* The keys and registers are set for every lane as a frame starts, and so only the padding has to be kept clear. */
+    this->lane_keys.assign(num_padded_lanes, LOCKSTEP_ENGINE_PARKED_KEY);
+    this->lane_registers_a.assign(num_padded_lanes, 0);
+    this->lane_registers_x.assign(num_padded_lanes, 0);
+    this->lane_registers_y.assign(num_padded_lanes, 0);
+    this->lane_registers_status.assign(num_padded_lanes, 0);
+    this->lane_operands.assign(num_padded_lanes, 0);
+    this->lane_results.assign(num_padded_lanes, 0);
+    this->lane_vector_masks.assign(num_padded_lanes, 0);
+
+    this->group_lane_indices.resize(num_lanes);
+    this->vector_lane_indices.resize(num_lanes);
+    this->vector_lane_operand_storages.resize(num_lanes);
+    this->vector_lane_operand_storage_offsets.resize(num_lanes);
+    this->vector_lane_address_modes.resize(num_lanes);
+
+    this->stats.num_lanes = num_lanes;
+}
+
+
+enum PeNESStatus LockstepEngine::step_frame()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    const std::array<enum LockstepEngineOperation, CPU_NUM_OPCODES> *operation_table = &LockstepEngine::get_operation_table();
+    enum LockstepEngineOperation lane_operation = LOCKSTEP_ENGINE_OPERATION_SCALAR;
+    enum LockstepEngineOperation vector_operation = LOCKSTEP_ENGINE_OPERATION_SCALAR;
+    std::size_t lane_index = 0;
+    std::size_t group_index = 0;
+    std::size_t num_loaded_lanes = 0;
+    std::size_t num_runnable_lanes = 0;
+    std::size_t num_group_lanes = 0;
+    std::size_t num_vector_lanes = 0;
+    std::uint32_t group_key = 0;
+    std::uint32_t bound_key = 0;
+    std::uint64_t num_ahead_instructions = 0;
+    native_word_t opcode_data = 0;
+    native_word_t vector_opcode_data = 0;
+    CPU *lane_cpu = nullptr;
+
+    for (lane_index = 0; lane_index < this->lane_cpus.size(); lane_index++) {
+        lane_cpu = this->lane_cpus[lane_index];
+
+        /* Dispatch whatever became due since the last frame, as CPU::step_frame does, without running anything. */
+        status = lane_cpu->run_until(lane_cpu->get_num_cycles());
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("run_until failed. Status: %d. Lane: %zu.\n", status, lane_index);
+            goto l_cleanup;
+        }
+
+        this->load_lane_registers(lane_index);
+        num_loaded_lanes++;
+
+        this->lane_target_cycles[lane_index] = CPU::get_frame_end_cycle(lane_cpu->get_num_frames());
+        this->update_lane_key(lane_index);
+        if (LOCKSTEP_ENGINE_PARKED_KEY != this->lane_keys[lane_index]) {
+            num_runnable_lanes++;
+        }
+    }
+
+    while (0 < num_runnable_lanes) {
+        group_key = LockstepEngine::find_min_key(this->lane_keys.data(), this->lane_keys.size());
+        num_group_lanes = LockstepEngine::find_lanes_with_key(
+            this->lane_keys.data(),
+            this->lane_keys.size(),
+            group_key,
+            this->group_lane_indices.data()
+        );
+        ASSERT(0 < num_group_lanes);
+
+        /* A lane alone at the lowest key would be selected alone again until it reaches the key of another lane,
+         * and so it runs ahead on its own machine until then, which selects the same instructions step by step would.
+         * */
+        if (1 == num_group_lanes) {
+            lane_index = this->group_lane_indices[0];
+            this->lane_keys[lane_index] = LOCKSTEP_ENGINE_PARKED_KEY;
+            bound_key = LockstepEngine::find_min_key(this->lane_keys.data(), this->lane_keys.size());
+            this->lane_keys[lane_index] = group_key;
+
+            status = this->run_lane_ahead(lane_index, bound_key, &num_ahead_instructions);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("run_lane_ahead failed. Status: %d. Lane: %zu.\n", status, lane_index);
+                goto l_cleanup;
+            }
+
+            this->stats.num_steps += num_ahead_instructions;
+            this->stats.num_lane_steps += num_ahead_instructions * this->lane_cpus.size();
+            this->stats.num_lane_instructions += num_ahead_instructions;
+            this->stats.num_runnable_lane_steps += num_ahead_instructions * num_runnable_lanes;
+            if (1 < num_runnable_lanes) {
+                this->stats.num_divergent_steps += num_ahead_instructions;
+            }
+
+            if (LOCKSTEP_ENGINE_PARKED_KEY == this->lane_keys[lane_index]) {
+                num_runnable_lanes--;
+            }
+
+            continue;
+        }
+
+        /* The first lane at an opcode the engine runs itself selects the vector operation of the step.
+         * The lanes at any other opcode, which may differ between lanes running code from RAM or another bank,
+         * run on their own machine.
+         * */
+        num_vector_lanes = 0;
+        for (group_index = 0; group_index < num_group_lanes; group_index++) {
+            lane_index = this->group_lane_indices[group_index];
+
+            status = this->lane_cpus[lane_index]->instruction_decoder.peek_opcode_data(&opcode_data);
+            lane_operation = (PENES_STATUS_SUCCESS == status)? operation_table->at(opcode_data): LOCKSTEP_ENGINE_OPERATION_SCALAR;
+
+            /* Decimal mode arithmetic is left to the machine. */
+            if ((true == system_cpu_variant_t::has_decimal_mode) &&
+                ((LOCKSTEP_ENGINE_OPERATION_ADC == lane_operation) || (LOCKSTEP_ENGINE_OPERATION_SBC == lane_operation)) &&
+                (0 != (this->lane_registers_status[lane_index] & REGISTER_STATUS_FLAG_MASK_DECIMAL))) {
+                lane_operation = LOCKSTEP_ENGINE_OPERATION_SCALAR;
+            }
+
+            if ((LOCKSTEP_ENGINE_OPERATION_SCALAR != lane_operation) && (0 == num_vector_lanes)) {
+                vector_operation = lane_operation;
+                vector_opcode_data = opcode_data;
+            }
+
+            if ((LOCKSTEP_ENGINE_OPERATION_SCALAR != lane_operation) && (vector_opcode_data == opcode_data)) {
+                this->vector_lane_indices[num_vector_lanes] = lane_index;
+                num_vector_lanes++;
+                continue;
+            }
+
+            status = this->step_lane(lane_index);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("step_lane failed. Status: %d. Lane: %zu.\n", status, lane_index);
+                goto l_cleanup;
+            }
+        }
+
+        if (0 < num_vector_lanes) {
+            status = this->step_vector_lanes(vector_operation, vector_opcode_data, num_vector_lanes);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("step_vector_lanes failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        }
+
+        this->stats.num_steps++;
+        this->stats.num_lane_steps += this->lane_cpus.size();
+        this->stats.num_lane_instructions += num_group_lanes;
+        this->stats.num_vector_lane_instructions += num_vector_lanes;
+        this->stats.num_runnable_lane_steps += num_runnable_lanes;
+        if (num_group_lanes < num_runnable_lanes) {
+            this->stats.num_divergent_steps++;
+        }
+
+        for (group_index = 0; group_index < num_group_lanes; group_index++) {
+            if (LOCKSTEP_ENGINE_PARKED_KEY == this->lane_keys[this->group_lane_indices[group_index]]) {
+                num_runnable_lanes--;
+            }
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    /* The machines hold the registers between frames. */
+    for (lane_index = 0; lane_index < num_loaded_lanes; lane_index++) {
+        this->store_lane_registers(lane_index);
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus LockstepEngine::step_lane(std::size_t lane_index)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    this->store_lane_registers(lane_index);
+    status = this->lane_cpus[lane_index]->step();
+    this->load_lane_registers(lane_index);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("step failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->update_lane_key(lane_index);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus LockstepEngine::run_lane_ahead(
+    std::size_t lane_index,
+    std::uint32_t bound_key,
+    std::uint64_t *output_num_instructions
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    CPU *lane_cpu = this->lane_cpus[lane_index];
+    std::uint64_t num_instructions = 0;
+
+    ASSERT(nullptr != output_num_instructions);
+
+    /* The machine holds the registers for as long as the lane runs ahead. */
+    this->store_lane_registers(lane_index);
+
+    do {
+        status = lane_cpu->step();
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("step failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        num_instructions++;
+        this->update_lane_key(lane_index);
+    } while (this->lane_keys[lane_index] < bound_key);
+
+    *output_num_instructions = num_instructions;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    this->load_lane_registers(lane_index);
+
+    return status;
+}
+
+
+enum PeNESStatus LockstepEngine::step_vector_lanes(
+    enum LockstepEngineOperation operation,
+    native_word_t opcode_data,
+    std::size_t num_vector_lanes
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    enum PeNESStatus release_status = PENES_STATUS_UNINITIALIZED;
+    std::size_t vector_index = 0;
+    std::size_t num_decoded_lanes = 0;
+    std::size_t lane_index = 0;
+    instruction_set::IOpcode *lane_opcode = nullptr;
+    native_word_t lane_opcode_data = 0;
+    CPU *lane_cpu = nullptr;
+    ProgramContext *lane_ctx = nullptr;
+    bool is_read_operation = false;
+    bool is_write_operation = false;
+
+    ASSERT(LOCKSTEP_ENGINE_OPERATION_SCALAR != operation);
+    ASSERT(num_vector_lanes <= this->vector_lane_indices.size());
+
+    switch (operation) {
+    case LOCKSTEP_ENGINE_OPERATION_STA:
+    case LOCKSTEP_ENGINE_OPERATION_STX:
+    case LOCKSTEP_ENGINE_OPERATION_STY:
+        is_write_operation = true;
+        break;
+
+    case LOCKSTEP_ENGINE_OPERATION_INC:
+    case LOCKSTEP_ENGINE_OPERATION_DEC:
+        is_read_operation = true;
+        is_write_operation = true;
+        break;
+
+    case LOCKSTEP_ENGINE_OPERATION_LDA:
+    case LOCKSTEP_ENGINE_OPERATION_LDX:
+    case LOCKSTEP_ENGINE_OPERATION_LDY:
+    case LOCKSTEP_ENGINE_OPERATION_AND:
+    case LOCKSTEP_ENGINE_OPERATION_ORA:
+    case LOCKSTEP_ENGINE_OPERATION_EOR:
+    case LOCKSTEP_ENGINE_OPERATION_ADC:
+    case LOCKSTEP_ENGINE_OPERATION_SBC:
+    case LOCKSTEP_ENGINE_OPERATION_CMP:
+    case LOCKSTEP_ENGINE_OPERATION_CPX:
+    case LOCKSTEP_ENGINE_OPERATION_CPY:
+        is_read_operation = true;
+        break;
+
+    default:
+        break;
+    }
+
+    /* Each lane decodes its instruction and reads its operand in its own memory map,
+     * which resolves the address mode, and performs any side effect of the read, exactly as the machine would.
+     * */
+    for (vector_index = 0; vector_index < num_vector_lanes; vector_index++) {
+        lane_index = this->vector_lane_indices[vector_index];
+        lane_cpu = this->lane_cpus[lane_index];
+
+        status = lane_cpu->instruction_decoder.decode_next_instruction(
+            &lane_opcode,
+            &this->vector_lane_address_modes[vector_index],
+            &this->vector_lane_operand_storages[vector_index],
+            &this->vector_lane_operand_storage_offsets[vector_index],
+            &lane_opcode_data
+        );
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("decode_next_instruction failed. Status: %d. Lane: %zu.\n", status, lane_index);
+            goto l_cleanup;
+        }
+
+        num_decoded_lanes++;
+        ASSERT(opcode_data == lane_opcode_data);
+
+        if (true == is_read_operation) {
+            status = this->vector_lane_operand_storages[vector_index]->read(
+                &this->lane_operands[lane_index],
+                sizeof(this->lane_operands[lane_index]),
+                this->vector_lane_operand_storage_offsets[vector_index]
+            );
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("Operand read failed. Status: %d. Lane: %zu.\n", status, lane_index);
+                goto l_cleanup;
+            }
+        }
+
+        this->lane_vector_masks[lane_index] = LOCKSTEP_ENGINE_LANE_MASK_SET;
+    }
+
+    /* The lanes are listed in ascending order, and so the vectors holding them lie between the first and the last. */
+    this->execute_vector_operation(
+        operation,
+        this->vector_lane_indices[0],
+        this->vector_lane_indices[num_vector_lanes - 1]
+    );
+
+    /* Write back the results, and complete each lane's instruction the way the machine does after executing it. */
+    for (vector_index = 0; vector_index < num_vector_lanes; vector_index++) {
+        lane_index = this->vector_lane_indices[vector_index];
+        lane_cpu = this->lane_cpus[lane_index];
+        lane_ctx = lane_cpu->program_ctx;
+
+        if (true == is_write_operation) {
+            status = this->vector_lane_operand_storages[vector_index]->write(
+                &this->lane_results[lane_index],
+                sizeof(this->lane_results[lane_index]),
+                this->vector_lane_operand_storage_offsets[vector_index]
+            );
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("Result write failed. Status: %d. Lane: %zu.\n", status, lane_index);
+                goto l_cleanup;
+            }
+        }
+
+        /* Clearing the Interrupt Disable flag lets an IRQ held while it was set through, as the machine's CLI does. */
+        if ((LOCKSTEP_ENGINE_OPERATION_CLI == operation) && (true == lane_ctx->is_irq_masked)) {
+            this->store_lane_registers(lane_index);
+            lane_ctx->release_masked_irq();
+        }
+
+        lane_cpu->account_instruction_cycles(opcode_data);
+        lane_cpu->num_instructions++;
+
+        /* An event may read or push the registers, which are handed to the machine for it. */
+        if (lane_ctx->num_cycles >= lane_ctx->event_scheduler.get_next_deadline()) {
+            this->store_lane_registers(lane_index);
+            status = lane_cpu->dispatch_events();
+            this->load_lane_registers(lane_index);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("dispatch_events failed. Status: %d. Lane: %zu.\n", status, lane_index);
+                goto l_cleanup;
+            }
+        }
+
+        this->update_lane_key(lane_index);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    for (vector_index = 0; vector_index < num_vector_lanes; vector_index++) {
+        lane_index = this->vector_lane_indices[vector_index];
+        this->lane_vector_masks[lane_index] = 0;
+
+        if (vector_index < num_decoded_lanes) {
+            release_status = this->vector_lane_address_modes[vector_index]->release_storage(
+                this->lane_cpus[lane_index]->program_ctx,
+                this->vector_lane_operand_storages[vector_index]
+            );
+            if ((PENES_STATUS_SUCCESS == status) && (PENES_STATUS_SUCCESS != release_status)) {
+                status = release_status;
+                DEBUG_PRINT_WITH_ARGS("release_storage failed. Status: %d. Lane: %zu.\n", status, lane_index);
+            }
+        }
+    }
+
+    return status;
+}
+
+
+void LockstepEngine::execute_vector_operation(
+    enum LockstepEngineOperation operation,
+    std::size_t first_lane_index,
+    std::size_t last_lane_index
+)
+{
+    std::size_t lane_index = 0;
+    lane_vector_t lane_mask;
+    lane_vector_t register_a;
+    lane_vector_t register_x;
+    lane_vector_t register_y;
+    lane_vector_t register_status;
+    lane_vector_t operand;
+    lane_vector_t result_a;
+    lane_vector_t result_x;
+    lane_vector_t result_y;
+    lane_vector_t result;
+    lane_vector_t compare_register;
+    lane_vector_t carry_mask;
+    lane_vector_t update_mask;
+    lane_vector_t update_values;
+
+    ASSERT(first_lane_index <= last_lane_index);
+    ASSERT(last_lane_index < this->lane_vector_masks.size());
+
+    for (
+        lane_index = first_lane_index - (first_lane_index % LOCKSTEP_ENGINE_LANES_PER_VECTOR);
+        lane_index <= last_lane_index;
+        lane_index += LOCKSTEP_ENGINE_LANES_PER_VECTOR
+    ) {
+        lane_mask = lane_vector_load(&this->lane_vector_masks[lane_index]);
+        if (true == lane_vector_is_zero(lane_mask)) {
+            continue;
+        }
+
+        register_a = lane_vector_load(&this->lane_registers_a[lane_index]);
+        register_x = lane_vector_load(&this->lane_registers_x[lane_index]);
+        register_y = lane_vector_load(&this->lane_registers_y[lane_index]);
+        register_status = lane_vector_load(&this->lane_registers_status[lane_index]);
+        operand = lane_vector_load(&this->lane_operands[lane_index]);
+
+        result_a = register_a;
+        result_x = register_x;
+        result_y = register_y;
+        result = lane_vector_set(0);
+        update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_NEGATIVE | REGISTER_STATUS_FLAG_MASK_ZERO);
+        update_values = lane_vector_set(0);
+
+        /* The flags are updated as the opcodes update them, see IUpdateStatusOperation. */
+        switch (operation) {
+        case LOCKSTEP_ENGINE_OPERATION_LDA:
+            result_a = operand;
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_LDX:
+            result_x = operand;
+            update_values = lane_vector_data_status(result_x);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_LDY:
+            result_y = operand;
+            update_values = lane_vector_data_status(result_y);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_STA:
+        case LOCKSTEP_ENGINE_OPERATION_STX:
+        case LOCKSTEP_ENGINE_OPERATION_STY:
+            result = (LOCKSTEP_ENGINE_OPERATION_STA == operation)? register_a:
+                     (LOCKSTEP_ENGINE_OPERATION_STX == operation)? register_x:
+                     register_y;
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_NONE);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_AND:
+            result_a = lane_vector_and(register_a, operand);
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_ORA:
+            result_a = lane_vector_or(register_a, operand);
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_EOR:
+            result_a = lane_vector_xor(register_a, operand);
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_ADC:
+        case LOCKSTEP_ENGINE_OPERATION_SBC:
+            /* A subtraction adds the complement of the operand, see OpcodeSBC. */
+            if (LOCKSTEP_ENGINE_OPERATION_SBC == operation) {
+                operand = lane_vector_xor(operand, lane_vector_set(LOCKSTEP_ENGINE_LANE_MASK_SET));
+            }
+
+            carry_mask = lane_vector_equal(
+                lane_vector_and(register_status, lane_vector_set(REGISTER_STATUS_FLAG_MASK_CARRY)),
+                lane_vector_set(REGISTER_STATUS_FLAG_MASK_CARRY)
+            );
+            result_a = lane_vector_add(
+                lane_vector_add(register_a, operand),
+                lane_vector_and(carry_mask, lane_vector_set(1))
+            );
+
+            /* The sum exceeded the word if it wrapped around to below A, or to A itself when the carry was added. */
+            result = lane_vector_clear(
+                lane_vector_greater_equal(register_a, result_a),
+                lane_vector_clear(lane_vector_equal(register_a, result_a), carry_mask)
+            );
+
+            /* The Carry flag is set when the sum exceeded the word, and inverted for a borrow,
+             * see update_arithmetic_status.
+             * */
+            if (LOCKSTEP_ENGINE_OPERATION_SBC == operation) {
+                result = lane_vector_xor(result, lane_vector_set(LOCKSTEP_ENGINE_LANE_MASK_SET));
+            }
+
+            update_mask = lane_vector_set(
+                REGISTER_STATUS_FLAG_MASK_NEGATIVE |
+                REGISTER_STATUS_FLAG_MASK_ZERO |
+                REGISTER_STATUS_FLAG_MASK_CARRY |
+                REGISTER_STATUS_FLAG_MASK_OVERFLOW
+            );
+            update_values = lane_vector_or(
+                lane_vector_data_status(result_a),
+                lane_vector_and(result, lane_vector_set(REGISTER_STATUS_FLAG_MASK_CARRY))
+            );
+
+            /* The Overflow flag is set when both operands have the same sign, but the sum has the other one. */
+            update_values = lane_vector_or(
+                update_values,
+                lane_vector_and(
+                    lane_vector_equal(
+                        lane_vector_and(
+                            lane_vector_clear(
+                                lane_vector_xor(operand, result_a),
+                                lane_vector_xor(register_a, operand)
+                            ),
+                            lane_vector_set(SYSTEM_NATIVE_WORD_SIGN_BIT_MASK)
+                        ),
+                        lane_vector_set(SYSTEM_NATIVE_WORD_SIGN_BIT_MASK)
+                    ),
+                    lane_vector_set(REGISTER_STATUS_FLAG_MASK_OVERFLOW)
+                )
+            );
+            result = lane_vector_set(0);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_CMP:
+        case LOCKSTEP_ENGINE_OPERATION_CPX:
+        case LOCKSTEP_ENGINE_OPERATION_CPY:
+            compare_register = (LOCKSTEP_ENGINE_OPERATION_CMP == operation)? register_a:
+                               (LOCKSTEP_ENGINE_OPERATION_CPX == operation)? register_x:
+                               register_y;
+
+            /* The Carry flag is set when the subtraction did not borrow, see ICompareOpcode. */
+            update_mask = lane_vector_set(
+                REGISTER_STATUS_FLAG_MASK_NEGATIVE | REGISTER_STATUS_FLAG_MASK_ZERO | REGISTER_STATUS_FLAG_MASK_CARRY
+            );
+            update_values = lane_vector_or(
+                lane_vector_data_status(lane_vector_sub(compare_register, operand)),
+                lane_vector_and(
+                    lane_vector_greater_equal(compare_register, operand),
+                    lane_vector_set(REGISTER_STATUS_FLAG_MASK_CARRY)
+                )
+            );
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_INC:
+            result = lane_vector_add(operand, lane_vector_set(1));
+            update_values = lane_vector_data_status(result);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_DEC:
+            result = lane_vector_sub(operand, lane_vector_set(1));
+            update_values = lane_vector_data_status(result);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_INX:
+            result_x = lane_vector_add(register_x, lane_vector_set(1));
+            update_values = lane_vector_data_status(result_x);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_INY:
+            result_y = lane_vector_add(register_y, lane_vector_set(1));
+            update_values = lane_vector_data_status(result_y);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_DEX:
+            result_x = lane_vector_sub(register_x, lane_vector_set(1));
+            update_values = lane_vector_data_status(result_x);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_DEY:
+            result_y = lane_vector_sub(register_y, lane_vector_set(1));
+            update_values = lane_vector_data_status(result_y);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_TAX:
+            result_x = register_a;
+            update_values = lane_vector_data_status(result_x);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_TAY:
+            result_y = register_a;
+            update_values = lane_vector_data_status(result_y);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_TXA:
+            result_a = register_x;
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_TYA:
+            result_a = register_y;
+            update_values = lane_vector_data_status(result_a);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_CLC:
+        case LOCKSTEP_ENGINE_OPERATION_SEC:
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_CARRY);
+            update_values = (LOCKSTEP_ENGINE_OPERATION_SEC == operation)? update_mask: lane_vector_set(0);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_CLI:
+        case LOCKSTEP_ENGINE_OPERATION_SEI:
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_INTERRUPT);
+            update_values = (LOCKSTEP_ENGINE_OPERATION_SEI == operation)? update_mask: lane_vector_set(0);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_CLD:
+        case LOCKSTEP_ENGINE_OPERATION_SED:
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_DECIMAL);
+            update_values = (LOCKSTEP_ENGINE_OPERATION_SED == operation)? update_mask: lane_vector_set(0);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_CLV:
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_OVERFLOW);
+            break;
+
+        case LOCKSTEP_ENGINE_OPERATION_NOP:
+            update_mask = lane_vector_set(REGISTER_STATUS_FLAG_MASK_NONE);
+            break;
+
+        default:
+            ASSERT(false);
+            break;
+        }
+
+        /* Only the selected lanes are updated, and the others keep their registers. */
+        lane_vector_store(&this->lane_registers_a[lane_index], lane_vector_select(lane_mask, result_a, register_a));
+        lane_vector_store(&this->lane_registers_x[lane_index], lane_vector_select(lane_mask, result_x, register_x));
+        lane_vector_store(&this->lane_registers_y[lane_index], lane_vector_select(lane_mask, result_y, register_y));
+        lane_vector_store(
+            &this->lane_registers_status[lane_index],
+            lane_vector_select(
+                lane_mask,
+                lane_vector_or(lane_vector_clear(register_status, update_mask), update_values),
+                register_status
+            )
+        );
+        lane_vector_store(&this->lane_results[lane_index], result);
+    }
+}
+
+
+void LockstepEngine::get_stats(struct LockstepEngineStats *output_stats) const
+{
+    struct LockstepEngineStats stats = this->stats;
+
+    ASSERT(nullptr != output_stats);
+
+    if (0 < stats.num_steps) {
+        stats.occupancy = static_cast<double>(stats.num_lane_instructions) / stats.num_lane_steps;
+        stats.convergence = static_cast<double>(stats.num_lane_instructions) / stats.num_runnable_lane_steps;
+        stats.divergence_rate = static_cast<double>(stats.num_divergent_steps) / stats.num_steps;
+        stats.vector_rate = static_cast<double>(stats.num_vector_lane_instructions) / stats.num_lane_instructions;
+    }
+
+    *output_stats = stats;
+}
+
+
+void LockstepEngine::write_stats(const struct LockstepEngineStats& stats, std::ostream& output_stream, bool is_json)
+{
+    if (true == is_json) {
+        output_stream << "{\"lanes\": " << stats.num_lanes
+                      << ", \"steps\": " << stats.num_steps
+                      << ", \"lane_instructions\": " << stats.num_lane_instructions
+                      << ", \"vector_lane_instructions\": " << stats.num_vector_lane_instructions
+                      << ", \"divergent_steps\": " << stats.num_divergent_steps
+                      << ", \"occupancy\": " << stats.occupancy
+                      << ", \"convergence\": " << stats.convergence
+                      << ", \"divergence_rate\": " << stats.divergence_rate
+                      << ", \"vector_rate\": " << stats.vector_rate << '}' << std::endl;
+        return;
+    }
+
+    output_stream << "Lanes: " << stats.num_lanes << std::endl
+                  << "Lockstep steps: " << stats.num_steps << std::endl
+                  << "Lane instructions: " << stats.num_lane_instructions << std::endl
+                  << "Vector lane instructions: " << stats.num_vector_lane_instructions << std::endl
+                  << "Divergent steps: " << stats.num_divergent_steps << std::endl
+                  << "Occupancy: " << stats.occupancy << std::endl
+                  << "Convergence: " << stats.convergence << std::endl
+                  << "Divergence rate: " << stats.divergence_rate << std::endl
+                  << "Vector rate: " << stats.vector_rate << std::endl;
+}
+
+
+std::uint32_t LockstepEngine::find_min_key(const std::uint32_t *keys, std::size_t num_keys)
+{
+    std::size_t key_index = 0;
+    std::uint32_t min_key = LOCKSTEP_ENGINE_PARKED_KEY;
+
+    ASSERT(nullptr != keys);
+    ASSERT(0 == num_keys % LOCKSTEP_ENGINE_KEYS_PER_VECTOR);
+
+#if defined(__AVX2__)
+    std::array<std::uint32_t, LOCKSTEP_ENGINE_KEYS_PER_VECTOR> vector_keys = {0};
+    __m256i min_vector = _mm256_set1_epi32(LOCKSTEP_ENGINE_PARKED_KEY);
+
+    for (key_index = 0; key_index < num_keys; key_index += LOCKSTEP_ENGINE_KEYS_PER_VECTOR) {
+        min_vector = _mm256_min_epu32(
+            min_vector,
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&keys[key_index]))
+        );
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(vector_keys.data()), min_vector);
+    for (std::uint32_t vector_key : vector_keys) {
+        min_key = MIN(min_key, vector_key);
+    }
+#elif defined(__SSE2__)
+    std::array<std::uint32_t, LOCKSTEP_ENGINE_KEYS_PER_VECTOR / 2> vector_keys = {0};
+    __m128i min_vector = _mm_set1_epi32(LOCKSTEP_ENGINE_PARKED_KEY);
+#if !defined(__SSE4_1__)
+    /* SSE2 only compares signed words, which order the keys as unsigned words once their sign bit is flipped. */
+    const __m128i sign_bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    __m128i key_vector;
+    __m128i is_lower;
+#endif
+
+    for (key_index = 0; key_index < num_keys; key_index += vector_keys.size()) {
+#if defined(__SSE4_1__)
+        min_vector = _mm_min_epu32(min_vector, _mm_loadu_si128(reinterpret_cast<const __m128i *>(&keys[key_index])));
+#else
+        key_vector = _mm_loadu_si128(reinterpret_cast<const __m128i *>(&keys[key_index]));
+        is_lower = _mm_cmpgt_epi32(_mm_xor_si128(min_vector, sign_bias), _mm_xor_si128(key_vector, sign_bias));
+        min_vector = _mm_or_si128(_mm_and_si128(is_lower, key_vector), _mm_andnot_si128(is_lower, min_vector));
+#endif
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(vector_keys.data()), min_vector);
+    for (std::uint32_t vector_key : vector_keys) {
+        min_key = MIN(min_key, vector_key);
+    }
+#else
+    for (key_index = 0; key_index < num_keys; key_index++) {
+        min_key = MIN(min_key, keys[key_index]);
+    }
+#endif
+
+    return min_key;
+}
+
+
+std::size_t LockstepEngine::find_lanes_with_key(
+    const std::uint32_t *keys,
+    std::size_t num_keys,
+    std::uint32_t key,
+    std::uint32_t *output_lane_indices
+)
+{
+    std::size_t key_index = 0;
+    std::size_t num_lanes = 0;
+
+    ASSERT(nullptr != keys);
+    ASSERT(nullptr != output_lane_indices);
+    ASSERT(0 == num_keys % LOCKSTEP_ENGINE_KEYS_PER_VECTOR);
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#if defined(__AVX2__)
+    const std::size_t keys_per_vector = LOCKSTEP_ENGINE_KEYS_PER_VECTOR;
+    const __m256i key_vector = _mm256_set1_epi32(key);
+#else
+    const std::size_t keys_per_vector = LOCKSTEP_ENGINE_KEYS_PER_VECTOR / 2;
+    const __m128i key_vector = _mm_set1_epi32(key);
+#endif
+    unsigned int match_mask = 0;
+
+    /* Each set bit of the compare mask is a matching lane of the vector, lowest lane first. */
+    for (key_index = 0; key_index < num_keys; key_index += keys_per_vector) {
+#if defined(__AVX2__)
+        match_mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(&keys[key_index])),
+            key_vector
+        )));
+#else
+        match_mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(&keys[key_index])),
+            key_vector
+        )));
+#endif
+
+        while (0 != match_mask) {
+            output_lane_indices[num_lanes] = key_index + __builtin_ctz(match_mask);
+            num_lanes++;
+            match_mask &= match_mask - 1;
+        }
+    }
+#else
+    for (key_index = 0; key_index < num_keys; key_index++) {
+        if (key == keys[key_index]) {
+            output_lane_indices[num_lanes] = key_index;
+            num_lanes++;
+        }
+    }
+#endif
+
+    return num_lanes;
+}
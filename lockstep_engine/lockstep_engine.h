@@ -0,0 +1,281 @@
+/**
+ * @brief  Lockstep execution of many machines, which runs together the lanes that are at the same instruction.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __LOCKSTEP_ENGINE_H__
+#define __LOCKSTEP_ENGINE_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "address_mode/address_mode_interface.h"
+#include "cpu/cpu.h"
+#include "storage_location/storage_location.h"
+
+/** Constants *************************************************************/
+/* The scheduling key of a lane that reached the end of its frame, which is above every program counter. */
+#define LOCKSTEP_ENGINE_PARKED_KEY (MEMORY_MAP_ADDRESS_SPACE_SIZE)
+/* The number of keys compared by the widest vector of keys. */
+#define LOCKSTEP_ENGINE_KEYS_PER_VECTOR (8)
+/* The lanes are padded with parked lanes to a multiple of the widest vector of registers, which holds 32 of them,
+ * and is a multiple of the widest vector of keys too, so that none of the vector loops has a tail.
+ * */
+#define LOCKSTEP_ENGINE_LANE_PADDING (32)
+
+/** Enums *****************************************************************/
+/** @brief The operations the engine runs on the registers of many lanes at once, one for each opcode it runs itself.
+ *         The other opcodes, such as the branches, jumps, stack operations and shifts, run on each machine on its own.
+ * */
+enum LockstepEngineOperation {
+    LOCKSTEP_ENGINE_OPERATION_SCALAR = 0,
+    LOCKSTEP_ENGINE_OPERATION_LDA,
+    LOCKSTEP_ENGINE_OPERATION_LDX,
+    LOCKSTEP_ENGINE_OPERATION_LDY,
+    LOCKSTEP_ENGINE_OPERATION_STA,
+    LOCKSTEP_ENGINE_OPERATION_STX,
+    LOCKSTEP_ENGINE_OPERATION_STY,
+    LOCKSTEP_ENGINE_OPERATION_AND,
+    LOCKSTEP_ENGINE_OPERATION_ORA,
+    LOCKSTEP_ENGINE_OPERATION_EOR,
+    LOCKSTEP_ENGINE_OPERATION_ADC,
+    LOCKSTEP_ENGINE_OPERATION_SBC,
+    LOCKSTEP_ENGINE_OPERATION_CMP,
+    LOCKSTEP_ENGINE_OPERATION_CPX,
+    LOCKSTEP_ENGINE_OPERATION_CPY,
+    LOCKSTEP_ENGINE_OPERATION_INC,
+    LOCKSTEP_ENGINE_OPERATION_DEC,
+    LOCKSTEP_ENGINE_OPERATION_INX,
+    LOCKSTEP_ENGINE_OPERATION_INY,
+    LOCKSTEP_ENGINE_OPERATION_DEX,
+    LOCKSTEP_ENGINE_OPERATION_DEY,
+    LOCKSTEP_ENGINE_OPERATION_TAX,
+    LOCKSTEP_ENGINE_OPERATION_TAY,
+    LOCKSTEP_ENGINE_OPERATION_TXA,
+    LOCKSTEP_ENGINE_OPERATION_TYA,
+    LOCKSTEP_ENGINE_OPERATION_CLC,
+    LOCKSTEP_ENGINE_OPERATION_SEC,
+    LOCKSTEP_ENGINE_OPERATION_CLI,
+    LOCKSTEP_ENGINE_OPERATION_SEI,
+    LOCKSTEP_ENGINE_OPERATION_CLD,
+    LOCKSTEP_ENGINE_OPERATION_SED,
+    LOCKSTEP_ENGINE_OPERATION_CLV,
+    LOCKSTEP_ENGINE_OPERATION_NOP,
+    LOCKSTEP_ENGINE_OPERATION_NUM_OPERATIONS
+};
+
+/** Structs ***************************************************************/
+/** @brief How well the lanes of a lockstep engine stayed together. */
+struct LockstepEngineStats {
+    std::uint64_t num_lanes = 0;
+    /* Each step runs a single instruction on every lane of the group it selected. */
+    std::uint64_t num_steps = 0;
+    /* The lanes of the engine, summed over the steps. */
+    std::uint64_t num_lane_steps = 0;
+    /* The instructions executed, summed over the lanes. */
+    std::uint64_t num_lane_instructions = 0;
+    /* The instructions executed by the vector operations, rather than by the machines on their own. */
+    std::uint64_t num_vector_lane_instructions = 0;
+    /* The lanes that had not reached the end of their frame, summed over the steps. */
+    std::uint64_t num_runnable_lane_steps = 0;
+    /* The steps on which the runnable lanes were at more than one instruction. */
+    std::uint64_t num_divergent_steps = 0;
+
+    /* The fraction of the lanes that ran on the average step. */
+    double occupancy = 0;
+    /* The fraction of the runnable lanes that ran on the average step,
+     * which leaves out the lanes that were idle only because their frame had already ended.
+     * */
+    double convergence = 0;
+    /* The fraction of the steps that were divergent. */
+    double divergence_rate = 0;
+    /* The fraction of the instructions that were executed by the vector operations. */
+    double vector_rate = 0;
+};
+
+/** Classes ***************************************************************/
+/** @brief Runs many machines, typically of the same ROM, as the lanes of a single engine.
+ *         On every step, the lanes at the lowest program counter run one instruction each, while the others wait,
+ *         and a lane alone there runs on until it reaches another lane.
+ *         Lanes that took different paths thus tend to meet again at the start of the code they share.
+ *
+ *         The registers A, X, Y and the Status register of the lanes are kept as arrays, a byte per lane,
+ *         rather than in the machines, for as long as a frame runs. When the lanes of a step are at an opcode
+ *         the engine runs itself, each lane decodes its instruction and accesses its operand in its own memory map,
+ *         and the operation itself runs on all of their registers at once, with AVX2 vector instructions
+ *         when the engine was compiled for them, and SSE2 otherwise on x86-64.
+ *         The lanes at any other opcode fall back to the machine's own step,
+ *         with their registers copied to and from it around the step.
+ * */
+class LockstepEngine {
+public:
+    /** @brief          Add a machine as a lane of the engine.
+     *
+     *  @param[in]      lane_cpu                    The machine, which must have been reset, and outlive the engine.
+     * */
+    void add_lane(CPU *lane_cpu);
+
+    /** @brief          Remove a machine from the lanes of the engine, between frames.
+     *
+     *  @param[in]      lane_cpu                    The machine, which must be a lane of the engine.
+     * */
+    void remove_lane(CPU *lane_cpu);
+
+    inline std::size_t get_num_lanes() const
+    {
+        return this->lane_cpus.size();
+    }
+
+    /** @brief Run every lane until the end of its current NTSC frame. See CPU::step_frame. */
+    enum PeNESStatus step_frame();
+
+    /** @brief          Retrieve how well the lanes stayed together, since they were added.
+     *
+     *  @param[out]     output_stats                The stats of the engine.
+     * */
+    void get_stats(struct LockstepEngineStats *output_stats) const;
+
+    /** @brief          Write the stats of an engine, either as human readable text or as a JSON object.
+     *
+     *  @param[in]      stats                       The stats to write.
+     *  @param[in]      output_stream               The stream to write to.
+     *  @param[in]      is_json                     Whether to write the stats as JSON.
+     * */
+    static void write_stats(const struct LockstepEngineStats& stats, std::ostream& output_stream, bool is_json);
+
+private:
+    /** @brief Resize the arrays of the lanes to the padded number of lanes. */
+    void resize_lanes();
+
+    /** @brief Update the scheduling key of a lane, after it ran or its frame target changed. */
+    inline void update_lane_key(std::size_t lane_index)
+    {
+        CPU *lane_cpu = this->lane_cpus[lane_index];
+
+        this->lane_keys[lane_index] = (lane_cpu->get_num_cycles() < this->lane_target_cycles[lane_index])?
+                                      lane_cpu->get_program_counter():
+                                      LOCKSTEP_ENGINE_PARKED_KEY;
+    }
+
+    /** @brief Copy the registers of a lane from its machine into the arrays of the engine. */
+    inline void load_lane_registers(std::size_t lane_index)
+    {
+        RegisterFile *register_file = &this->lane_cpus[lane_index]->program_ctx->register_file;
+
+        this->lane_registers_a[lane_index] = register_file->get_register_a()->read();
+        this->lane_registers_x[lane_index] = register_file->get_register_x()->read();
+        this->lane_registers_y[lane_index] = register_file->get_register_y()->read();
+        this->lane_registers_status[lane_index] = register_file->get_register_status()->read();
+    }
+
+    /** @brief Copy the registers of a lane from the arrays of the engine back into its machine. */
+    inline void store_lane_registers(std::size_t lane_index)
+    {
+        RegisterFile *register_file = &this->lane_cpus[lane_index]->program_ctx->register_file;
+
+        register_file->get_register_a()->write(this->lane_registers_a[lane_index]);
+        register_file->get_register_x()->write(this->lane_registers_x[lane_index]);
+        register_file->get_register_y()->write(this->lane_registers_y[lane_index]);
+        register_file->get_register_status()->write(this->lane_registers_status[lane_index]);
+    }
+
+    /** @brief Run a single instruction of a lane on its machine, and dispatch any event due after it. */
+    enum PeNESStatus step_lane(std::size_t lane_index);
+
+    /** @brief          Run a lane on its machine until its key reaches a bound, or it parks.
+     *
+     *  @param[in]      lane_index                  The lane to run, which runs at least one instruction.
+     *  @param[in]      bound_key                   The lowest key of the other lanes.
+     *  @param[out]     output_num_instructions     The number of instructions run.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus run_lane_ahead(std::size_t lane_index, std::uint32_t bound_key, std::uint64_t *output_num_instructions);
+
+    /** @brief          Run an instruction of an opcode the engine runs itself on a number of lanes,
+     *                  and dispatch any event due after it on each of them.
+     *
+     *  @param[in]      operation                   The operation of the opcode.
+     *  @param[in]      opcode_data                 The encoded opcode byte.
+     *  @param[in]      num_vector_lanes            The number of lanes, listed in vector_lane_indices.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus step_vector_lanes(
+        enum LockstepEngineOperation operation,
+        native_word_t opcode_data,
+        std::size_t num_vector_lanes
+    );
+
+    /** @brief          Run an operation on the registers of every lane selected by lane_vector_masks.
+     *
+     *  @param[in]      operation                   The operation to run.
+     *  @param[in]      first_lane_index            The lowest selected lane.
+     *  @param[in]      last_lane_index             The highest selected lane.
+     * */
+    void execute_vector_operation(
+        enum LockstepEngineOperation operation,
+        std::size_t first_lane_index,
+        std::size_t last_lane_index
+    );
+
+    /** @brief Retrieve the operation of each opcode, built on first use from the opcode types of the decoder. */
+    static const std::array<enum LockstepEngineOperation, CPU_NUM_OPCODES>& get_operation_table();
+
+    /** @brief Find the lowest key, which is LOCKSTEP_ENGINE_PARKED_KEY if every lane is parked. */
+    static std::uint32_t find_min_key(const std::uint32_t *keys, std::size_t num_keys);
+
+    /** @brief          Find the lanes that have a key.
+     *
+     *  @param[in]      keys                        The keys, a multiple of LOCKSTEP_ENGINE_KEYS_PER_VECTOR of them.
+     *  @param[in]      num_keys                    The number of keys.
+     *  @param[in]      key                         The key to find.
+     *  @param[out]     output_lane_indices         The indices of the lanes found, in ascending order.
+     *
+     *  @return         The number of lanes found.
+     * */
+    static std::size_t find_lanes_with_key(
+        const std::uint32_t *keys,
+        std::size_t num_keys,
+        std::uint32_t key,
+        std::uint32_t *output_lane_indices
+    );
+
+    std::vector<CPU *> lane_cpus;
+    /* The cycle each lane's current frame ends on. */
+    std::vector<std::uint64_t> lane_target_cycles;
+    /* The program counter of each runnable lane, and LOCKSTEP_ENGINE_PARKED_KEY for the others. */
+    std::vector<std::uint32_t> lane_keys;
+
+    /* The registers of each lane, which are only kept here while a frame runs. */
+    std::vector<native_word_t> lane_registers_a;
+    std::vector<native_word_t> lane_registers_x;
+    std::vector<native_word_t> lane_registers_y;
+    std::vector<native_word_t> lane_registers_status;
+    /* The data operand each lane read for the current vector operation. */
+    std::vector<native_word_t> lane_operands;
+    /* The data each lane writes back for the current vector operation. */
+    std::vector<native_word_t> lane_results;
+    /* All ones for the lanes the current vector operation runs on, and zero for the others. */
+    std::vector<native_word_t> lane_vector_masks;
+
+    /* The lanes selected for the current step. */
+    std::vector<std::uint32_t> group_lane_indices;
+    /* The lanes of the current step that run the vector operation, along with the operand each of them decoded. */
+    std::vector<std::uint32_t> vector_lane_indices;
+    std::vector<IStorageLocation *> vector_lane_operand_storages;
+    std::vector<std::size_t> vector_lane_operand_storage_offsets;
+    std::vector<address_mode::IAddressMode *> vector_lane_address_modes;
+    struct LockstepEngineStats stats;
+};
+
+#endif /* __LOCKSTEP_ENGINE_H__ */
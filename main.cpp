@@ -1,19 +1,76 @@
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
 #include "rom_loader/rom_loader.h"
+#include "rom_index/rom_index.h"
 #include "cpu/cpu.h"
 #include "program_context/program_context.h"
 #include "utils/utils.h"
 #include "storage_location/storage_location.h"
 
+#ifdef PENES_MEMORY_PROFILER
+#include "memory_profiler/memory_profiler.h"
+#endif
+
 #define ROM_INPUT_FILE ("./test/Super Mario Bros. (World).nes")
+#define ROM_INDEX_FILE ("./penes.idx")
+#define ROM_SAVE_FILE ("./test/Super Mario Bros. (World).sav")
+#define MEMORY_PROFILER_OUTPUT_FILE ("./memory_profile.csv")
+#define PENES_JSON_REPORT_OPTION ("--json")
+#define PENES_REAL_TIME_OPTION ("--real-time")
+#define PENES_SPEED_OPTION ("--speed")
+
+static void print_usage(const char *program_name)
+{
+    std::cout << "Usage: " << program_name << " [" << PENES_JSON_REPORT_OPTION << "]"
+              << " [" << PENES_REAL_TIME_OPTION << " | " << PENES_SPEED_OPTION << " <multiplier>]" << std::endl;
+}
+
 
 using namespace utils;
-int main()
+int main(int argc, char **argv)
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    ROMIndex rom_index;
+    const struct ROMIndexEntry *rom_index_entry = nullptr;
+    struct CPUPerformanceReport performance_report;
+    bool is_json_report = false;
+    enum CPUPacingMode pacing_mode = CPU_PACING_MODE_UNTHROTTLED;
+    double speed_multiplier = 1;
+    int argument_index = 0;
+
+    /* Runs are unthrottled unless a pacing mode is requested. */
+    for (argument_index = 1; argument_index < argc; argument_index++) {
+        if (CMP_EQUAL == strcmp(PENES_JSON_REPORT_OPTION, argv[argument_index])) {
+            is_json_report = true;
+        } else if (CMP_EQUAL == strcmp(PENES_REAL_TIME_OPTION, argv[argument_index])) {
+            pacing_mode = CPU_PACING_MODE_REAL_TIME;
+        } else if ((argument_index + 1 < argc) && (CMP_EQUAL == strcmp(PENES_SPEED_OPTION, argv[argument_index]))) {
+            pacing_mode = CPU_PACING_MODE_MULTIPLIER;
+            speed_multiplier = strtod(argv[++argument_index], nullptr);
+            if (0 >= speed_multiplier) {
+                print_usage(argv[0]);
+                return -1;
+            }
+        } else {
+            print_usage(argv[0]);
+            return -1;
+        }
+    }
 
-    /* Initialize ROM loader to load the input ROM file. */
+    /* Initialize ROM loader to load the input ROM file.
+     * The file is memory mapped, so that the PRG-ROM banks are used in place rather than copied.
+     * If the file is in an up to date library index, its header is taken from the index rather than parsed.
+     * */
     ROMLoader rom_loader;
-    status = rom_loader.open(ROM_INPUT_FILE);
+    if ((PENES_STATUS_SUCCESS == rom_index.load(ROM_INDEX_FILE)) &&
+        (PENES_STATUS_SUCCESS == rom_index.find_entry(ROM_INPUT_FILE, &rom_index_entry))) {
+        status = rom_loader.open_with_header(ROM_INPUT_FILE, rom_index_entry->header, true);
+    } else {
+        status = rom_loader.open(ROM_INPUT_FILE, true);
+    }
     if (PENES_STATUS_SUCCESS != status) {
         DEBUG_PRINT_WITH_ARGS("Open failed. Status: %d.\n", status);
         return -1;
@@ -22,7 +79,62 @@ int main()
     /* Initialize a program context object. */
     ProgramContext program_ctx(&rom_loader);
 
+    /* Persist the SRAM of battery-backed cartridges in a save file. */
+    if (true == rom_loader.is_battery_backed()) {
+        status = program_ctx.memory_map.map_battery_sram(ROM_SAVE_FILE);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("map_battery_sram failed. Status: %d.\n", status);
+            return -1;
+        }
+    }
+
+#ifdef PENES_MEMORY_PROFILER
+    /* Count the accesses to every guest address, to be dumped as a heatmap once the run is over. */
+    MemoryProfiler memory_profiler(rom_loader.get_num_prg_rom_banks());
+    status = program_ctx.memory_map.attach_memory_profiler(&memory_profiler);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("attach_memory_profiler failed. Status: %d.\n", status);
+        return -1;
+    }
+#endif
+
     /* Initialize and run the emulator CPU. */
     CPU emulator(&program_ctx);
-    emulator.run();
+    emulator.set_pacing_mode(pacing_mode, speed_multiplier);
+    status = emulator.run(CPU_DEFAULT_RUN_NUM_FRAMES, &performance_report);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("run failed. Status: %d.\n", status);
+        return -1;
+    }
+
+    CPU::write_performance_report(performance_report, std::cout, is_json_report);
+
+    /* Report which PRG-ROM banks the run has loaded, unless the output is kept to the JSON report. */
+    if (false == is_json_report) {
+        std::cout << "Resident PRG-ROM banks: " << program_ctx.memory_map.get_num_resident_prg_rom_banks()
+                  << " of " << rom_loader.get_num_prg_rom_banks() << std::endl;
+        for (std::size_t bank_index = 0; bank_index < rom_loader.get_num_prg_rom_banks(); bank_index++) {
+            const struct MemoryMapPRGROMBankStats& bank_stats = program_ctx.memory_map.get_prg_rom_bank_stats()[bank_index];
+            if (true == bank_stats.is_resident) {
+                std::cout << "  Bank " << bank_index << ": selected " << bank_stats.num_selections << " times" << std::endl;
+            }
+        }
+    }
+
+    /* Wait for the save to reach the disk before exiting. */
+    if (true == program_ctx.memory_map.is_battery_sram_mapped()) {
+        status = program_ctx.memory_map.flush_battery_sram(true);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("flush_battery_sram failed. Status: %d.\n", status);
+            return -1;
+        }
+    }
+
+#ifdef PENES_MEMORY_PROFILER
+    status = memory_profiler.dump_csv(MEMORY_PROFILER_OUTPUT_FILE);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("dump_csv failed. Status: %d.\n", status);
+        return -1;
+    }
+#endif
 }
@@ -6,6 +6,12 @@
 
 /** Headers ***************************************************************/
 #include <algorithm>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "common.h"
 #include "penes_status.h"
@@ -16,6 +22,10 @@
 #define MEMORY_MAP_PRG_ROM_FIRST_BANK_INDEX (0)
 #define MEMORY_MAP_PRG_ROM_SECOND_BANK_INDEX (1)
 
+#define MEMORY_MAP_BATTERY_SRAM_FILE_MODE (0644)
+
+#define MEMORY_MAP_ADDRESS_SPACE_IMAGE_NAME ("penes-address-space")
+
 /** Static Variables ******************************************************/
 const std::vector<enum MemoryMapAddress> MemoryMap::address_keys = {
     MEMORY_MAP_ADDRESS_START_ZERO_PAGE,            /* Zero Page */
@@ -31,17 +41,282 @@ const std::vector<enum MemoryMapAddress> MemoryMap::address_keys = {
     MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER         /* PRG-ROM Upper Bank */
 };
 
+/* The writable regions of the address space, whose writes are recorded when dirty tracking is enabled. */
+const std::vector<enum MemoryMapAddress> MemoryMap::dirty_tracking_address_keys = {
+    MEMORY_MAP_ADDRESS_START_ZERO_PAGE,
+    MEMORY_MAP_ADDRESS_START_STACK,
+    MEMORY_MAP_ADDRESS_START_RAM,
+    MEMORY_MAP_ADDRESS_START_RAM_MIRROR,
+    MEMORY_MAP_ADDRESS_START_SRAM
+};
+
+/* The I/O register regions, whose accesses can be forwarded to peripherals. */
+const std::vector<enum MemoryMapAddress> MemoryMap::peripheral_address_keys = {
+    MEMORY_MAP_ADDRESS_START_IO_REGISTERS,
+    MEMORY_MAP_ADDRESS_START_IO_MIRROR,
+    MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2
+};
+
+/* The PRG-ROM regions, which are views into the selected banks and drop writes. */
+const std::vector<enum MemoryMapAddress> MemoryMap::prg_rom_address_keys = {
+    MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER,
+    MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER
+};
+
 /** Functions *************************************************************/
-MemoryMap::MemoryMap()
+enum PeNESStatus ROMMemoryStorage::write(
+    const native_word_t *write_buffer,
+    std::size_t num_write_words,
+    std::size_t write_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != write_buffer);
+
+    /* Verify that the area to write is within the bounds of the region, as any other write would, and drop it. */
+    if (this->storage_size < system_words_to_bytes(write_word_offset + num_write_words)) {
+        status = PENES_STATUS_STORAGE_LOCATION_WRITE_OUT_OF_BOUNDS;
+        DEBUG_PRINT_WITH_ARGS(
+            "Requested write area exceeds the bounds of the region. Status: %d. Write size: %zu, write offset: %zu\n",
+            status,
+            num_write_words,
+            write_word_offset
+        );
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus WriteCountingMemoryStorage::write(
+    const native_word_t *write_buffer,
+    std::size_t num_write_words,
+    std::size_t write_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != write_buffer);
+
+    status = IStorageLocation::write(write_buffer, num_write_words, write_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Superclass write failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    (*this->write_generation)++;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus DirtyTrackingMemoryStorage::write(
+    const native_word_t *write_buffer,
+    std::size_t num_write_words,
+    std::size_t write_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t page_index = 0;
+    std::size_t last_page_index = 0;
+
+    ASSERT(nullptr != write_buffer);
+
+    status = WriteCountingMemoryStorage::write(write_buffer, num_write_words, write_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Superclass write failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    /* Mark every page covered by the written area as dirty. */
+    page_index = MEMORY_MAP_ADDRESS_TO_PAGE(this->start_address + write_word_offset);
+    last_page_index = MEMORY_MAP_ADDRESS_TO_PAGE(this->start_address + write_word_offset + num_write_words - 1);
+    for (; page_index <= last_page_index; page_index++) {
+        this->dirty_pages->set(page_index);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus WatchpointMemoryStorage::read(
+    native_word_t *read_buffer,
+    std::size_t num_read_words,
+    std::size_t read_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != read_buffer);
+
+    status = this->region_storage->read(read_buffer, num_read_words, read_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Region storage read failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    /* Report the words that have been read, along with their values. */
+    this->memory_map->notify_watchpoints(
+        this->start_address + read_word_offset,
+        read_buffer,
+        num_read_words,
+        MEMORY_WATCHPOINT_TYPE_READ
+    );
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus WatchpointMemoryStorage::write(
+    const native_word_t *write_buffer,
+    std::size_t num_write_words,
+    std::size_t write_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != write_buffer);
+
+    status = this->region_storage->write(write_buffer, num_write_words, write_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Region storage write failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    /* Report the words that have been written, along with their new values. */
+    this->memory_map->notify_watchpoints(
+        this->start_address + write_word_offset,
+        write_buffer,
+        num_write_words,
+        MEMORY_WATCHPOINT_TYPE_WRITE
+    );
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus PeripheralMemoryStorage::read(
+    native_word_t *read_buffer,
+    std::size_t num_read_words,
+    std::size_t read_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t word_index = 0;
+
+    ASSERT(nullptr != read_buffer);
+
+    /* Without a peripheral, the last written values are read back. */
+    status = IStorageLocation::read(read_buffer, num_read_words, read_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Superclass read failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    if (nullptr == this->peripheral) {
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* Catch the peripheral up before reading, since its registers reflect its state at the current cycle. */
+    status = this->peripheral->sync(*this->cycle_counter);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("sync failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    for (word_index = 0; word_index < num_read_words; word_index++) {
+        status = this->peripheral->read_register(
+            this->get_register_address(read_word_offset + word_index),
+            &read_buffer[word_index]
+        );
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("read_register failed. Status: %d\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus PeripheralMemoryStorage::write(
+    const native_word_t *write_buffer,
+    std::size_t num_write_words,
+    std::size_t write_word_offset
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t word_index = 0;
+
+    ASSERT(nullptr != write_buffer);
+
+    status = WriteCountingMemoryStorage::write(write_buffer, num_write_words, write_word_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Superclass write failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    if (nullptr == this->peripheral) {
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* Catch the peripheral up before writing, so that the write takes effect at the current cycle
+     * rather than at the cycle the peripheral was last synchronized to.
+     * */
+    status = this->peripheral->sync(*this->cycle_counter);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("sync failed. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    for (word_index = 0; word_index < num_write_words; word_index++) {
+        status = this->peripheral->write_register(
+            this->get_register_address(write_word_offset + word_index),
+            write_buffer[word_index]
+        );
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("write_register failed. Status: %d\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+MemoryMap::MemoryMap(bool is_dirty_tracking_enabled): dirty_tracking_enabled(is_dirty_tracking_enabled)
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
     std::vector<enum MemoryMapAddress>::const_iterator address_key_iter;
     std::size_t memory_storage_size = 0;
     std::size_t next_address_start = 0;
 
+    /* Allocate the single buffer backing every region of the address space. */
+    status = this->allocate_address_space();
+    ASSERT(PENES_STATUS_SUCCESS == status);
+
     /* Iterate through the address key table.
      * Create a new storage object for each entry in the map,
      * with the size being the distance between the entry's start address and the following entry's start address.
+     * Each storage object is a view into the address space buffer, at the entry's start address.
      * */
     for (
         address_key_iter = MemoryMap::address_keys.begin();
@@ -56,29 +331,77 @@ MemoryMap::MemoryMap()
         }
 
         memory_storage_size = next_address_start - *address_key_iter;
-        this->storage_table.push_back(new MemoryStorage(memory_storage_size));
+
+        /* Writable regions are created with the tracked write path only when dirty tracking is requested,
+         * so that a map without tracking only pays for counting the writes.
+         * */
+        if ((true == this->dirty_tracking_enabled) &&
+            (MemoryMap::dirty_tracking_address_keys.end() != std::find(
+                MemoryMap::dirty_tracking_address_keys.begin(),
+                MemoryMap::dirty_tracking_address_keys.end(),
+                *address_key_iter
+            ))) {
+            this->storage_table.push_back(new DirtyTrackingMemoryStorage(
+                this->address_space_buffer + *address_key_iter,
+                memory_storage_size,
+                &this->write_generation,
+                *address_key_iter,
+                &this->dirty_pages
+            ));
+        } else if (MemoryMap::peripheral_address_keys.end() != std::find(
+                       MemoryMap::peripheral_address_keys.begin(),
+                       MemoryMap::peripheral_address_keys.end(),
+                       *address_key_iter
+                   )) {
+            this->storage_table.push_back(new PeripheralMemoryStorage(
+                this->address_space_buffer + *address_key_iter,
+                memory_storage_size,
+                &this->write_generation,
+                *address_key_iter
+            ));
+        } else if (MemoryMap::prg_rom_address_keys.end() != std::find(
+                       MemoryMap::prg_rom_address_keys.begin(),
+                       MemoryMap::prg_rom_address_keys.end(),
+                       *address_key_iter
+                   )) {
+            this->storage_table.push_back(new ROMMemoryStorage(
+                this->address_space_buffer + *address_key_iter,
+                memory_storage_size
+            ));
+        } else {
+            this->storage_table.push_back(new WriteCountingMemoryStorage(
+                this->address_space_buffer + *address_key_iter,
+                memory_storage_size,
+                &this->write_generation
+            ));
+        }
     }
 
+    /* No region is watched yet, and so none has a watchpoint storage object. */
+    this->watchpoint_storage_table.resize(this->storage_table.size(), nullptr);
+
+    /* Map each page of the address space to the region containing it. */
+    status = this->setup_page_table();
+    ASSERT(PENES_STATUS_SUCCESS == status);
+
     /* Search the table and setup the storage object shortcuts for common calls. */
     status = this->setup_storage_shortcuts();
     ASSERT(PENES_STATUS_SUCCESS == status);
 }
 
 
-MemoryMap::MemoryMap(ROMLoader *rom_loader): MemoryMap()
+MemoryMap::MemoryMap(ROMLoader *rom_loader, bool is_dirty_tracking_enabled): MemoryMap(is_dirty_tracking_enabled)
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    MemoryStorage *lower_prg_rom_storage = nullptr;
-    MemoryStorage *upper_prg_rom_storage = nullptr;
     std::size_t num_prg_rom_banks = 0;
     std::size_t prg_rom_upper_bank_index = MEMORY_MAP_PRG_ROM_SECOND_BANK_INDEX;
 
     ASSERT(nullptr != rom_loader);
 
     /* Retrieve the number PRG-ROM banks contained within the file.
-     * If there are two banks, we would like to load both into the upper/lower PRG-ROM memory storage, respectively.
-     * If there is only one bank, we will load it into both upper and lower storage.
-     * If there are more than two banks, bank switching is required.
+     * If there are two banks, we would like to select them into the lower/upper PRG-ROM slots, respectively.
+     * If there is only one bank, we will select it into both slots.
+     * If there are more than two banks, the rest are only loaded once the mapper selects them.
      * */
     num_prg_rom_banks = rom_loader->get_num_prg_rom_banks();
     if (0 == num_prg_rom_banks) {
@@ -87,78 +410,258 @@ MemoryMap::MemoryMap(ROMLoader *rom_loader): MemoryMap()
         prg_rom_upper_bank_index = MEMORY_MAP_PRG_ROM_FIRST_BANK_INDEX;
     }
 
-    /* Retrieve the lower PRG-ROM bank memory storage. */
-    status = this->get_memory_storage(
-        MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER,
-        &lower_prg_rom_storage
-    );
+    this->rom_loader = rom_loader;
+    this->prg_rom_banks.resize(num_prg_rom_banks, nullptr);
+    this->prg_rom_bank_copies.resize(num_prg_rom_banks);
+    this->prg_rom_bank_stats.resize(num_prg_rom_banks, {false, 0});
+
+    status = this->select_prg_rom_bank(MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER, MEMORY_MAP_PRG_ROM_FIRST_BANK_INDEX);
     ASSERT(PENES_STATUS_SUCCESS == status);
 
-    /* Write the ROM bank directly into the memory storage buffer. */
-    status = rom_loader->get_prg_rom_bank(
-        MEMORY_MAP_PRG_ROM_FIRST_BANK_INDEX,
-        reinterpret_cast<char *>(lower_prg_rom_storage->storage_buffer)
-    );
+    status = this->select_prg_rom_bank(MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER, prg_rom_upper_bank_index);
     ASSERT(PENES_STATUS_SUCCESS == status);
+}
 
-    /* Retrieve the upper PRG-ROM bank memory storage. */
-    status = this->get_memory_storage(
-        MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER,
-        &upper_prg_rom_storage
+
+MemoryMap::MemoryMap(const MemoryMap *source_memory_map): MemoryMap(source_memory_map->dirty_tracking_enabled)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t bank_index = 0;
+
+    if (nullptr == source_memory_map->rom_loader) {
+        return;
+    }
+
+    /* Resident banks are never written, since writes to PRG-ROM are dropped, and so they are shared as they are. */
+    this->rom_loader = source_memory_map->rom_loader;
+    this->prg_rom_banks = source_memory_map->prg_rom_banks;
+    this->prg_rom_bank_copies = source_memory_map->prg_rom_bank_copies;
+    this->prg_rom_bank_stats.resize(source_memory_map->prg_rom_bank_stats.size(), {false, 0});
+    for (bank_index = 0; bank_index < this->prg_rom_banks.size(); bank_index++) {
+        this->prg_rom_bank_stats[bank_index].is_resident = (nullptr != this->prg_rom_banks[bank_index]);
+    }
+
+    this->num_resident_prg_rom_banks = source_memory_map->num_resident_prg_rom_banks;
+
+    status = this->select_prg_rom_bank(
+        MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER,
+        source_memory_map->prg_rom_bank_indices[0]
     );
     ASSERT(PENES_STATUS_SUCCESS == status);
 
-    /* Write the ROM bank directly into the memory storage buffer. */
-    status = rom_loader->get_prg_rom_bank(
-        prg_rom_upper_bank_index,
-        reinterpret_cast<char *>(upper_prg_rom_storage->storage_buffer)
+    status = this->select_prg_rom_bank(
+        MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER,
+        source_memory_map->prg_rom_bank_indices[1]
     );
     ASSERT(PENES_STATUS_SUCCESS == status);
 }
 
 
-enum PeNESStatus MemoryMap::get_memory_storage(
+enum PeNESStatus MemoryMap::select_prg_rom_bank(enum MemoryMapAddress prg_rom_address, std::size_t bank_index)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    MemoryStorage *prg_rom_storage = nullptr;
+    native_word_t *prg_rom_bank = nullptr;
+    std::size_t slot_index = 0;
+
+    if (MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER == prg_rom_address) {
+        slot_index = 0;
+    } else if (MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER == prg_rom_address) {
+        slot_index = 1;
+    } else {
+        status = PENES_STATUS_MEMORY_MAP_SELECT_PRG_ROM_BANK_INVALID_ADDRESS;
+        DEBUG_PRINT_WITH_ARGS("Not a PRG-ROM slot. Status: %d. Address: %x\n", status, prg_rom_address);
+        goto l_cleanup;
+    }
+
+    if (this->prg_rom_banks.size() <= bank_index) {
+        status = PENES_STATUS_MEMORY_MAP_SELECT_PRG_ROM_BANK_OUT_OF_BOUNDS;
+        DEBUG_PRINT_WITH_ARGS("PRG-ROM bank out of bounds. Status: %d. Bank: %zu\n", status, bank_index);
+        goto l_cleanup;
+    }
+
+    status = this->load_prg_rom_bank(bank_index, &prg_rom_bank);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("load_prg_rom_bank failed. Status: %d. Bank: %zu\n", status, bank_index);
+        goto l_cleanup;
+    }
+
+    /* Retrieve the storage of the PRG-ROM region itself, and make it a view into the bank. */
+    status = this->find_storage(prg_rom_address, false, &prg_rom_storage, nullptr);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_storage failed. Status: %d. Address: %x\n", status, prg_rom_address);
+        goto l_cleanup;
+    }
+
+    prg_rom_storage->storage_buffer = prg_rom_bank;
+    this->prg_rom_bank_indices[slot_index] = bank_index;
+    this->prg_rom_bank_stats[bank_index].num_selections++;
+
+    /* The jump vectors mirror the upper PRG-ROM bank, and so they have to follow it. */
+    if (MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER == prg_rom_address) {
+        delete this->irq_jump_vector_storage;
+        delete this->nmi_jump_vector_storage;
+        delete this->reset_jump_vector_storage;
+
+        status = this->setup_storage_shortcuts();
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("setup_storage_shortcuts failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::load_prg_rom_bank(std::size_t bank_index, native_word_t **output_bank)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::shared_ptr<std::vector<native_word_t>> bank_copy;
+
+    ASSERT(nullptr != this->rom_loader);
+    ASSERT(nullptr != output_bank);
+
+    if (nullptr != this->prg_rom_banks[bank_index]) {
+        *output_bank = this->prg_rom_banks[bank_index];
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* A memory mapped or owned ROM image is used in place: the bank is a view into the image.
+     * Otherwise, the bank is copied into a buffer of its own.
+     * */
+    if (true == this->rom_loader->is_image_in_place()) {
+        status = this->rom_loader->map_prg_rom_bank(bank_index, &this->prg_rom_banks[bank_index]);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("map_prg_rom_bank failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    } else {
+        bank_copy = std::make_shared<std::vector<native_word_t>>(ROM_LOADER_PRG_ROM_BANK_SIZE);
+
+        status = this->rom_loader->get_prg_rom_bank(bank_index, reinterpret_cast<char *>(bank_copy->data()));
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_prg_rom_bank failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->prg_rom_banks[bank_index] = bank_copy->data();
+        this->prg_rom_bank_copies[bank_index] = bank_copy;
+    }
+
+    this->prg_rom_bank_stats[bank_index].is_resident = true;
+    this->num_resident_prg_rom_banks++;
+
+    *output_bank = this->prg_rom_banks[bank_index];
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::find_storage(
     native_address_t address,
+    bool is_data_access,
     MemoryStorage **output_storage,
     std::size_t *output_storage_offset
 ) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    const struct Page *page = nullptr;
+    std::size_t page_index = MEMORY_MAP_ADDRESS_TO_PAGE(address);
+    std::size_t region_index = 0;
+    std::size_t region_offset = 0;
+
+    ASSERT(nullptr != output_storage);
+
+    /* Most pages belong to a single region, and so the storage is retrieved directly from the page table. */
+    page = &this->page_table[page_index];
+    if (nullptr != page->storage) {
+        *output_storage = (true == is_data_access)? page->storage: page->region_storage;
+
+        if (nullptr != output_storage_offset) {
+            *output_storage_offset = page->storage_offset + (address & MEMORY_MAP_PAGE_OFFSET_MASK);
+        }
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* The page is split between multiple regions, search for the region containing the address. */
+    status = this->find_region(address, &region_index, &region_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Address: %x\n", status, address);
+        goto l_cleanup;
+    }
+
+    /* Only regions holding a watchpoint have a watchpoint storage object,
+     * other regions sharing the page are accessed directly.
+     * */
+    if ((true == is_data_access) &&
+        (true == this->watched_pages.test(page_index)) &&
+        (nullptr != this->watchpoint_storage_table.at(region_index))) {
+        *output_storage = this->watchpoint_storage_table.at(region_index);
+    } else {
+        *output_storage = this->storage_table.at(region_index);
+    }
+
+    if (nullptr != output_storage_offset) {
+        *output_storage_offset = region_offset;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::find_region(
+    native_address_t address,
+    std::size_t *output_region_index,
+    std::size_t *output_region_offset
+) const
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
     std::vector<enum MemoryMapAddress>::const_iterator address_key_iter;
     std::size_t memory_storage_index = 0;
 
-    ASSERT(nullptr != output_storage);
+    ASSERT(nullptr != output_region_index);
+    ASSERT(nullptr != output_region_offset);
 
     /* Find the memory storage key that "contains" the address,
      * meaning the largest key that is smaller or equal.
-     * Note that lower_bound will return the first key not smaller than the address,
-     * and so we need to rewind the iterator in case the key is not equal to the address.
+     * Note that upper_bound will return the first key greater than the address,
+     * and so the containing key is the one preceding it.
+     * This also covers addresses past the last key, which belong to the last storage object.
      * */
-    address_key_iter = std::lower_bound(
+    address_key_iter = std::upper_bound(
         MemoryMap::address_keys.begin(),
         MemoryMap::address_keys.end(),
         address
     );
-    if (MemoryMap::address_keys.end() == address_key_iter) {
+    if (MemoryMap::address_keys.begin() == address_key_iter) {
         status = PENES_STATUS_MEMORY_MAP_GET_MEMORY_STORAGE_NOT_FOUND;
         DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
-            "lower_bound failed: no matching address found. Status: %d. Search address: %x\n",
+            "upper_bound failed: no matching address found. Status: %d. Search address: %x\n",
             status,
             address
         );
         goto l_cleanup;
     }
 
-    if (*address_key_iter != address) {
-        address_key_iter--;
-    }
+    address_key_iter--;
 
     /* Calculate the index of the found address key within the vector,
     * so that we can extract the storage object from the memory map.
     * */
     memory_storage_index = address_key_iter - MemoryMap::address_keys.begin();
 
-    /* Verify the index is within the bounds of the memory map and retrieve the memory storage object. */
+    /* Verify the index is within the bounds of the memory map. */
     if (this->storage_table.size() <= memory_storage_index) {
         status = PENES_STATUS_MEMORY_MAP_GET_MEMORY_STORAGE_OUT_OF_BOUNDS;
         DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
@@ -173,11 +676,8 @@ enum PeNESStatus MemoryMap::get_memory_storage(
      * is the distance between the given address and the matched address key,
      * since the key represents the first cell of the storage object.
      * */
-    *output_storage = this->storage_table.at(memory_storage_index);
-
-    if (nullptr != output_storage_offset) {
-        *output_storage_offset = address - *address_key_iter;
-    }
+    *output_region_index = memory_storage_index;
+    *output_region_offset = address - *address_key_iter;
 
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
@@ -185,35 +685,370 @@ l_cleanup:
 }
 
 
-enum PeNESStatus MemoryMap::setup_storage_shortcuts()
+enum PeNESStatus MemoryMap::setup_page_table()
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    MemoryStorage *upper_prg_rom_storage = nullptr;
+    std::size_t page_index = 0;
+    std::size_t first_region_index = 0;
+    std::size_t last_region_index = 0;
+    std::size_t first_region_offset = 0;
+    std::size_t last_region_offset = 0;
+    native_address_t page_address = 0;
 
-    /* Retrieve the upper PRG-ROM bank memory storage. */
-    status = this->get_memory_storage(
-        MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER,
-        &upper_prg_rom_storage
-    );
+    /* Map every page that is fully contained in a single region directly to the region's storage.
+     * Pages shared by multiple regions (such as the I/O registers and their mirrors) are left empty,
+     * and are resolved by searching the region table instead.
+     * */
+    for (page_index = 0; page_index < MEMORY_MAP_NUM_PAGES; page_index++) {
+        page_address = page_index << MEMORY_MAP_PAGE_SIZE_BITS;
+
+        status = this->find_region(page_address, &first_region_index, &first_region_offset);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Page: %zu\n", status, page_index);
+            goto l_cleanup;
+        }
+
+        status = this->find_region(page_address + MEMORY_MAP_PAGE_OFFSET_MASK, &last_region_index, &last_region_offset);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Page: %zu\n", status, page_index);
+            goto l_cleanup;
+        }
+
+        if (first_region_index == last_region_index) {
+            this->page_table[page_index] = {
+                this->storage_table.at(first_region_index),
+                this->storage_table.at(first_region_index),
+                first_region_offset
+            };
+        } else {
+            this->page_table[page_index] = {nullptr, nullptr, 0};
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::add_watchpoint(
+    native_address_t address,
+    enum MemoryWatchpointType watchpoint_type,
+    memory_watchpoint_callback_t callback,
+    void *callback_context
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t page_index = MEMORY_MAP_ADDRESS_TO_PAGE(address);
+    std::size_t region_index = 0;
+    std::size_t region_offset = 0;
+
+    ASSERT(nullptr != callback);
+
+    if (0 == (watchpoint_type & MEMORY_WATCHPOINT_TYPE_READ_WRITE)) {
+        status = PENES_STATUS_MEMORY_MAP_ADD_WATCHPOINT_INVALID_TYPE;
+        DEBUG_PRINT_WITH_ARGS("Invalid watchpoint type. Status: %d. Type: %d\n", status, watchpoint_type);
+        goto l_cleanup;
+    }
+
+    /* Create the storage object standing in for the region containing the address, if there is none yet. */
+    status = this->find_region(address, &region_index, &region_offset);
     if (PENES_STATUS_SUCCESS != status) {
-        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
-            "get_memory_storage failed. Status: %d. Index: %d\n",
-            status,
-            MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Address: %x\n", status, address);
+        goto l_cleanup;
+    }
+
+    this->create_watchpoint_storage(region_index);
+
+    /* Replacing an existing watchpoint does not change the number of watchpoints in the page. */
+    if (this->watchpoints.end() == this->watchpoints.find(address)) {
+        this->num_page_watchpoints[page_index]++;
+    }
+
+    this->watchpoints[address] = {watchpoint_type, callback, callback_context};
+
+    status = this->watch_page(page_index);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("watch_page failed. Status: %d. Page: %zu\n", status, page_index);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void MemoryMap::create_watchpoint_storage(std::size_t region_index)
+{
+    if (nullptr == this->watchpoint_storage_table.at(region_index)) {
+        this->watchpoint_storage_table.at(region_index) = new WatchpointMemoryStorage(
+            this->storage_table.at(region_index),
+            MemoryMap::address_keys.at(region_index),
+            this
+        );
+    }
+}
+
+
+enum PeNESStatus MemoryMap::watch_page(std::size_t page_index)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct Page *page = &this->page_table[page_index];
+    std::size_t region_index = 0;
+    std::size_t region_offset = 0;
+
+    /* Divert data accesses to the page to the watched access path.
+     * Split pages are diverted by the flag alone, since their storage is resolved on every access.
+     * */
+    this->watched_pages.set(page_index);
+
+    if (nullptr != page->region_storage) {
+        status = this->find_region(page_index << MEMORY_MAP_PAGE_SIZE_BITS, &region_index, &region_offset);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Page: %zu\n", status, page_index);
+            goto l_cleanup;
+        }
+
+        this->create_watchpoint_storage(region_index);
+        page->storage = this->watchpoint_storage_table.at(region_index);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+#ifdef PENES_MEMORY_PROFILER
+enum PeNESStatus MemoryMap::attach_memory_profiler(MemoryProfiler *memory_profiler)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t region_index = 0;
+    std::size_t page_index = 0;
+
+    ASSERT(nullptr != memory_profiler);
+
+    this->memory_profiler = memory_profiler;
+
+    /* Every region is accessed through the watched access path, including those sharing split pages. */
+    for (region_index = 0; region_index < this->storage_table.size(); region_index++) {
+        this->create_watchpoint_storage(region_index);
+    }
+
+    for (page_index = 0; page_index < MEMORY_MAP_NUM_PAGES; page_index++) {
+        status = this->watch_page(page_index);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("watch_page failed. Status: %d. Page: %zu\n", status, page_index);
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+#endif
+
+
+enum PeNESStatus MemoryMap::attach_peripheral(
+    enum MemoryMapAddress io_address,
+    IPeripheral *peripheral,
+    const std::uint64_t *cycle_counter
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != peripheral);
+    ASSERT(nullptr != cycle_counter);
+
+    switch (io_address) {
+    case MEMORY_MAP_ADDRESS_START_IO_REGISTERS:
+        /* The PPU registers are mirrored every few bytes up to the second I/O register region. */
+        status = this->attach_peripheral_storage(
+            MEMORY_MAP_ADDRESS_START_IO_REGISTERS,
+            peripheral,
+            cycle_counter,
+            MEMORY_MAP_ADDRESS_START_IO_REGISTERS,
+            MEMORY_MAP_ADDRESS_START_IO_MIRROR - MEMORY_MAP_ADDRESS_START_IO_REGISTERS
+        );
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("attach_peripheral_storage failed. Status: %d\n", status);
+            goto l_cleanup;
+        }
+
+        status = this->attach_peripheral_storage(
+            MEMORY_MAP_ADDRESS_START_IO_MIRROR,
+            peripheral,
+            cycle_counter,
+            MEMORY_MAP_ADDRESS_START_IO_REGISTERS,
+            MEMORY_MAP_ADDRESS_START_IO_MIRROR - MEMORY_MAP_ADDRESS_START_IO_REGISTERS
+        );
+        break;
+
+    case MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2:
+        status = this->attach_peripheral_storage(
+            MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2,
+            peripheral,
+            cycle_counter,
+            MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2,
+            MEMORY_MAP_ADDRESS_START_EXPANSION_ROM - MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2
         );
+        break;
+
+    default:
+        status = PENES_STATUS_MEMORY_MAP_ATTACH_PERIPHERAL_INVALID_ADDRESS;
+        break;
+    }
+
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("Failed to attach peripheral. Status: %d. Address: %x\n", status, io_address);
+        goto l_cleanup;
+    }
+
+    /* A peripheral may serve both I/O register regions, but is only synchronized once per event. */
+    if (this->peripherals.end() == std::find(this->peripherals.begin(), this->peripherals.end(), peripheral)) {
+        this->peripherals.push_back(peripheral);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::attach_peripheral_storage(
+    enum MemoryMapAddress region_address,
+    IPeripheral *peripheral,
+    const std::uint64_t *cycle_counter,
+    native_address_t register_base_address,
+    std::size_t num_registers
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t region_index = 0;
+    std::size_t region_offset = 0;
+
+    status = this->find_region(region_address, &region_index, &region_offset);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("find_region failed. Status: %d. Address: %x\n", status, region_address);
         goto l_cleanup;
     }
 
-    /* Search the table for "common" memory storage objects, in able to provide "shortcut" retrieval methods. */
-    status = this->get_memory_storage(
-        MEMORY_MAP_ADDRESS_START_STACK,
-        &this->stack_storage
+    /* The I/O register regions are always created as peripheral storage, see the constructor. */
+    static_cast<PeripheralMemoryStorage *>(this->storage_table.at(region_index))->attach_peripheral(
+        peripheral,
+        cycle_counter,
+        register_base_address,
+        num_registers
+    );
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::remove_watchpoint(native_address_t address)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t page_index = MEMORY_MAP_ADDRESS_TO_PAGE(address);
+    struct Page *page = nullptr;
+
+    if (0 == this->watchpoints.erase(address)) {
+        status = PENES_STATUS_MEMORY_MAP_REMOVE_WATCHPOINT_NOT_FOUND;
+        DEBUG_PRINT_WITH_ARGS("No watchpoint at address. Status: %d. Address: %x\n", status, address);
+        goto l_cleanup;
+    }
+
+    /* Once the last watchpoint of the page is removed, restore the page to the direct access path,
+     * unless a memory profiler still requires every access to be reported.
+     * */
+    this->num_page_watchpoints[page_index]--;
+#ifdef PENES_MEMORY_PROFILER
+    if ((0 == this->num_page_watchpoints[page_index]) && (nullptr == this->memory_profiler)) {
+#else
+    if (0 == this->num_page_watchpoints[page_index]) {
+#endif
+        this->watched_pages.reset(page_index);
+
+        page = &this->page_table[page_index];
+        page->storage = page->region_storage;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void MemoryMap::notify_watchpoints(
+    native_address_t address,
+    const native_word_t *access_buffer,
+    std::size_t num_access_words,
+    enum MemoryWatchpointType access_type
+) const
+{
+    std::unordered_map<native_address_t, struct Watchpoint>::const_iterator watchpoint_iter;
+    struct MemoryWatchpointEvent watchpoint_event = {0};
+    std::size_t word_index = 0;
+
+    ASSERT(nullptr != access_buffer);
+
+#ifdef PENES_MEMORY_PROFILER
+    if (nullptr != this->memory_profiler) {
+        this->memory_profiler->record_access(
+            address,
+            this->get_prg_rom_bank_index(address),
+            (MEMORY_WATCHPOINT_TYPE_READ == access_type)?
+                MEMORY_PROFILER_ACCESS_TYPE_READ:
+                MEMORY_PROFILER_ACCESS_TYPE_WRITE,
+            num_access_words
+        );
+    }
+#endif
+
+    if (true == this->watchpoints.empty()) {
+        return;
+    }
+
+    watchpoint_event.program_counter = this->instruction_address;
+    watchpoint_event.access_type = access_type;
+
+    /* Report every accessed word that is watched for this type of access. */
+    for (word_index = 0; word_index < num_access_words; word_index++) {
+        watchpoint_iter = this->watchpoints.find(address + word_index);
+        if ((this->watchpoints.end() == watchpoint_iter) ||
+            (0 == (watchpoint_iter->second.watchpoint_type & access_type))) {
+            continue;
+        }
+
+        watchpoint_event.address = address + word_index;
+        watchpoint_event.value = access_buffer[word_index];
+
+        watchpoint_iter->second.callback(&watchpoint_event, watchpoint_iter->second.callback_context);
+    }
+}
+
+
+enum PeNESStatus MemoryMap::setup_storage_shortcuts()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    MemoryStorage *upper_prg_rom_storage = nullptr;
+
+    /* Retrieve the upper PRG-ROM bank memory storage.
+     * The data access lookup would return the watchpoint storage standing in for the region if its page is watched,
+     * which views no buffer of its own, and so the region's storage is retrieved as for an instruction fetch.
+     * */
+    status = this->get_instruction_storage(
+        MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER,
+        &upper_prg_rom_storage
     );
     if (PENES_STATUS_SUCCESS != status) {
         DEBUG_PRINT_WITH_ERRNO_WITH_ARGS(
-            "get_memory_storage failed for Stack. Status: %d. Index: %d\n",
+            "get_instruction_storage failed. Status: %d. Index: %d\n",
             status,
-            MEMORY_MAP_ADDRESS_START_STACK
+            MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER
         );
         goto l_cleanup;
     }
@@ -242,4 +1077,381 @@ enum PeNESStatus MemoryMap::setup_storage_shortcuts()
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
     return status;
-}
\ No newline at end of file
+}
+
+
+enum PeNESStatus MemoryMap::map_battery_sram(const std::string& save_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    MemoryStorage *sram_storage = nullptr;
+    int save_file_descriptor = -1;
+    struct stat save_file_stat = {0};
+    void *save_file_mapping = MAP_FAILED;
+
+    if (nullptr != this->battery_sram_storage) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_ALREADY_MAPPED;
+        DEBUG_PRINT_WITH_ARGS("Battery SRAM is already mapped. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Retrieve the storage of the SRAM region itself, rather than any storage standing in for it. */
+    status = this->find_storage(MEMORY_MAP_ADDRESS_START_SRAM, false, &sram_storage, nullptr);
+    if (PENES_STATUS_SUCCESS != status) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_GET_STORAGE_FAILED;
+        DEBUG_PRINT_WITH_ARGS("find_storage failed for SRAM. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    save_file_descriptor = open(save_file.c_str(), O_RDWR | O_CREAT, MEMORY_MAP_BATTERY_SRAM_FILE_MODE);
+    if (-1 == save_file_descriptor) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* A new or truncated save file is extended to the size of the SRAM, reading back as zeros. */
+    if (-1 == fstat(save_file_descriptor, &save_file_stat)) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_FSTAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("fstat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if ((MEMORY_MAP_SRAM_SIZE > save_file_stat.st_size) &&
+        (-1 == ftruncate(save_file_descriptor, MEMORY_MAP_SRAM_SIZE))) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_FTRUNCATE_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("ftruncate failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Map the file over the SRAM region of the address space buffer.
+     * The mapping is shared with the file, so that every write to the SRAM is a write to the save file.
+     * All storage objects keep viewing the same addresses, and so they observe the mapping without being updated.
+     * */
+    save_file_mapping = mmap(
+        sram_storage->storage_buffer,
+        MEMORY_MAP_SRAM_SIZE,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_FIXED,
+        save_file_descriptor,
+        0
+    );
+    if (MAP_FAILED == save_file_mapping) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_MMAP_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("mmap failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->battery_sram_storage = sram_storage;
+    this->write_generation++;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    /* The mapping holds its own reference to the file. */
+    if (-1 != save_file_descriptor) {
+        close(save_file_descriptor);
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::flush_battery_sram(bool is_blocking)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    if (nullptr == this->battery_sram_storage) {
+        status = PENES_STATUS_MEMORY_MAP_FLUSH_BATTERY_SRAM_NOT_MAPPED;
+        DEBUG_PRINT_WITH_ARGS("Battery SRAM is not mapped. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (-1 == msync(
+        this->battery_sram_storage->storage_buffer,
+        MEMORY_MAP_SRAM_SIZE,
+        (true == is_blocking)? MS_SYNC: MS_ASYNC
+    )) {
+        status = PENES_STATUS_MEMORY_MAP_FLUSH_BATTERY_SRAM_MSYNC_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("msync failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::clone_address_space(MemoryMap *source_memory_map)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    int image_descriptor = -1;
+    std::size_t slot_index = 0;
+
+    ASSERT(nullptr != source_memory_map);
+    ASSERT(this != source_memory_map);
+    ASSERT(this->rom_loader == source_memory_map->rom_loader);
+
+    /* Mapping the image over the address space would drop whatever is mapped or diverted in this map. */
+    if ((nullptr != this->battery_sram_storage) ||
+        (false == this->watchpoints.empty()) ||
+        (false == this->peripherals.empty())) {
+        status = PENES_STATUS_MEMORY_MAP_CLONE_ADDRESS_SPACE_NOT_FRESH;
+        DEBUG_PRINT_WITH_ARGS("The memory map is not fresh. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+#ifdef PENES_MEMORY_PROFILER
+    if (nullptr != this->memory_profiler) {
+        status = PENES_STATUS_MEMORY_MAP_CLONE_ADDRESS_SPACE_NOT_FRESH;
+        DEBUG_PRINT_WITH_ARGS("The memory map is not fresh. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+#endif
+
+    status = source_memory_map->freeze_address_space(&image_descriptor);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("freeze_address_space failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->map_address_space_image(image_descriptor, 0, this->address_space_mapping_size);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("map_address_space_image failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Banks are resident for good once loaded, and so selecting the source's banks is only a change of buffers. */
+    for (slot_index = 0; slot_index < MEMORY_MAP_NUM_PRG_ROM_SLOTS; slot_index++) {
+        if ((MEMORY_MAP_PRG_ROM_BANK_NONE == source_memory_map->prg_rom_bank_indices[slot_index]) ||
+            (this->prg_rom_bank_indices[slot_index] == source_memory_map->prg_rom_bank_indices[slot_index])) {
+            continue;
+        }
+
+        status = this->select_prg_rom_bank(
+            (0 == slot_index)? MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER: MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER,
+            source_memory_map->prg_rom_bank_indices[slot_index]
+        );
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("select_prg_rom_bank failed. Status: %d. Slot: %zu.\n", status, slot_index);
+            goto l_cleanup;
+        }
+    }
+
+    this->dirty_pages = source_memory_map->dirty_pages;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::freeze_address_space(int *output_image_descriptor)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    int image_descriptor = -1;
+
+    ASSERT(nullptr != output_image_descriptor);
+
+    /* Until the map writes, its address space is still the image it was last frozen into, which is shared as it is. */
+    if ((-1 != this->frozen_image_descriptor) && (this->frozen_write_generation == this->write_generation)) {
+        *output_image_descriptor = this->frozen_image_descriptor;
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    image_descriptor = memfd_create(MEMORY_MAP_ADDRESS_SPACE_IMAGE_NAME, MFD_CLOEXEC);
+    if (-1 == image_descriptor) {
+        status = PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_MEMFD_CREATE_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("memfd_create failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The image spans the whole mapping of the address space, which is longer than the address space itself
+     * when huge pages are enabled, so that no part of the mapping lies past the end of the image.
+     * */
+    if (-1 == ftruncate(image_descriptor, this->address_space_mapping_size)) {
+        status = PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_FTRUNCATE_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("ftruncate failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Writing the image is the only copy of the address space that cloning takes. */
+    if (MEMORY_MAP_ADDRESS_SPACE_SIZE != pwrite(
+        image_descriptor,
+        this->address_space_buffer,
+        MEMORY_MAP_ADDRESS_SPACE_SIZE,
+        0
+    )) {
+        status = PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_PWRITE_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("pwrite failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* A battery-backed SRAM stays mapped to its save file, and so only the ranges around it are remapped. */
+    if (nullptr == this->battery_sram_storage) {
+        status = this->map_address_space_image(image_descriptor, 0, this->address_space_mapping_size);
+    } else {
+        status = this->map_address_space_image(image_descriptor, 0, MEMORY_MAP_ADDRESS_START_SRAM);
+        if (PENES_STATUS_SUCCESS == status) {
+            status = this->map_address_space_image(
+                image_descriptor,
+                MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER,
+                this->address_space_mapping_size - MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER
+            );
+        }
+    }
+
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("map_address_space_image failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The previous image is only kept alive by the mappings of the clones that still share it. */
+    this->release_frozen_image();
+
+    this->frozen_image_descriptor = image_descriptor;
+    this->frozen_write_generation = this->write_generation;
+    image_descriptor = -1;
+
+    *output_image_descriptor = this->frozen_image_descriptor;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (-1 != image_descriptor) {
+        close(image_descriptor);
+    }
+
+    return status;
+}
+
+
+void MemoryMap::release_frozen_image()
+{
+    if (-1 == this->frozen_image_descriptor) {
+        return;
+    }
+
+    close(this->frozen_image_descriptor);
+
+    this->frozen_image_descriptor = -1;
+}
+
+
+enum PeNESStatus MemoryMap::map_address_space_image(
+    int image_descriptor,
+    std::size_t start_address,
+    std::size_t num_words
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    void *image_mapping = MAP_FAILED;
+
+    /* Storage objects keep viewing the same addresses, and so they observe the new mapping without being updated. */
+    image_mapping = mmap(
+        this->address_space_buffer + start_address,
+        num_words,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_FIXED,
+        image_descriptor,
+        start_address
+    );
+    if (MAP_FAILED == image_mapping) {
+        status = PENES_STATUS_MEMORY_MAP_MAP_ADDRESS_SPACE_IMAGE_MMAP_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("mmap failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+#ifdef PENES_HUGE_PAGES
+    /* The mapping replaces part of the huge page the address space was allocated as, and so it asks for one too,
+     * which the kernel only grants when its shmem transparent huge pages are enabled.
+     * */
+    madvise(image_mapping, num_words, MADV_HUGEPAGE);
+#endif
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus MemoryMap::allocate_address_space()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    void *address_space_mapping = MAP_FAILED;
+    std::size_t mapping_size = MEMORY_MAP_ADDRESS_SPACE_SIZE;
+
+#ifdef PENES_HUGE_PAGES
+    std::uintptr_t mapping_start = 0;
+    std::uintptr_t aligned_start = 0;
+
+    /* Over-allocate, so that a huge page aligned range can be carved out of the mapping. */
+    mapping_size = MEMORY_MAP_HUGE_PAGE_SIZE * 2;
+#endif
+
+    /* Anonymous mappings are page aligned, and so the buffer is cache line aligned as well. */
+    address_space_mapping = mmap(
+        nullptr,
+        mapping_size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (MAP_FAILED == address_space_mapping) {
+        status = PENES_STATUS_MEMORY_MAP_ALLOCATE_ADDRESS_SPACE_MMAP_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("mmap failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+#ifdef PENES_HUGE_PAGES
+    /* Trim the mapping to a single aligned huge page, and ask for it to be backed by one. */
+    mapping_start = reinterpret_cast<std::uintptr_t>(address_space_mapping);
+    aligned_start = (mapping_start + MEMORY_MAP_HUGE_PAGE_SIZE - 1) & ~(MEMORY_MAP_HUGE_PAGE_SIZE - 1);
+
+    if (aligned_start > mapping_start) {
+        munmap(address_space_mapping, aligned_start - mapping_start);
+    }
+
+    munmap(
+        reinterpret_cast<void *>(aligned_start + MEMORY_MAP_HUGE_PAGE_SIZE),
+        mapping_start + mapping_size - aligned_start - MEMORY_MAP_HUGE_PAGE_SIZE
+    );
+
+    address_space_mapping = reinterpret_cast<void *>(aligned_start);
+    mapping_size = MEMORY_MAP_HUGE_PAGE_SIZE;
+
+    /* Huge pages are only a hint, and so failing to get one is not an error. */
+    madvise(address_space_mapping, mapping_size, MADV_HUGEPAGE);
+#endif
+
+    this->address_space_buffer = static_cast<native_word_t *>(address_space_mapping);
+    this->address_space_mapping_size = mapping_size;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void MemoryMap::release_address_space()
+{
+    if (nullptr == this->address_space_buffer) {
+        return;
+    }
+
+    /* Unmapping the address space also unmaps the save file mapped over the SRAM region,
+     * and so wait for the save to be written back first.
+     * */
+    if (nullptr != this->battery_sram_storage) {
+        msync(this->battery_sram_storage->storage_buffer, MEMORY_MAP_SRAM_SIZE, MS_SYNC);
+        this->battery_sram_storage = nullptr;
+    }
+
+    this->release_frozen_image();
+
+    munmap(this->address_space_buffer, this->address_space_mapping_size);
+
+    this->address_space_buffer = nullptr;
+    this->address_space_mapping_size = 0;
+}
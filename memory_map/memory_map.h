@@ -8,15 +8,41 @@
 #define __MEMORY_MAP_H__
 
 /** Headers ***************************************************************/
+#include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "penes_status.h"
+#include "common.h"
 #include "system.h"
 
 #include "storage_location/storage_location.h"
 #include "rom_loader/rom_loader.h"
+#include "peripheral/peripheral_interface.h"
+
+#ifdef PENES_MEMORY_PROFILER
+#include "memory_profiler/memory_profiler.h"
+#endif
+
+/** Constants *************************************************************/
+#define MEMORY_MAP_PAGE_SIZE_BITS (8)
+#define MEMORY_MAP_PAGE_SIZE (1 << MEMORY_MAP_PAGE_SIZE_BITS)
+#define MEMORY_MAP_NUM_PAGES (0x10000 >> MEMORY_MAP_PAGE_SIZE_BITS)
+#define MEMORY_MAP_PAGE_OFFSET_MASK (MEMORY_MAP_PAGE_SIZE - 1)
+#define MEMORY_MAP_NUM_PRG_ROM_SLOTS (2)
+#define MEMORY_MAP_PRG_ROM_BANK_NONE (SIZE_MAX)
+#define MEMORY_MAP_ADDRESS_SPACE_SIZE (0x10000)
+#define MEMORY_MAP_HUGE_PAGE_SIZE (0x200000)
+#define MEMORY_MAP_SRAM_SIZE (MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER - MEMORY_MAP_ADDRESS_START_SRAM)
+
+/** Macros ****************************************************************/
+/* Retrieve the index of the page containing the address. */
+#define MEMORY_MAP_ADDRESS_TO_PAGE(address) ((address) >> MEMORY_MAP_PAGE_SIZE_BITS)
 
 /** Enums *****************************************************************/
 enum MemoryMapAddress {
@@ -38,6 +64,33 @@ enum MemoryMapAddress {
     MEMORY_MAP_ADDRESS_END = 0x10000
 };
 
+enum MemoryWatchpointType {
+    MEMORY_WATCHPOINT_TYPE_NONE = 0,
+    MEMORY_WATCHPOINT_TYPE_READ = 1 << 0,
+    MEMORY_WATCHPOINT_TYPE_WRITE = 1 << 1,
+    MEMORY_WATCHPOINT_TYPE_READ_WRITE = MEMORY_WATCHPOINT_TYPE_READ | MEMORY_WATCHPOINT_TYPE_WRITE
+};
+
+/** Structs ***************************************************************/
+/** @brief Description of a single watched memory access, passed to the watchpoint callback. */
+struct MemoryWatchpointEvent {
+    /* Address of the instruction performing the access. */
+    native_address_t program_counter;
+    native_address_t address;
+    native_word_t value;
+    enum MemoryWatchpointType access_type;
+};
+
+/** Typedefs **************************************************************/
+/** @brief Residency of a single PRG-ROM bank, which is only loaded the first time it is selected. */
+struct MemoryMapPRGROMBankStats {
+    bool is_resident;
+    /* The number of times the bank has been selected into a PRG-ROM slot. */
+    std::uint64_t num_selections;
+};
+
+typedef void (*memory_watchpoint_callback_t)(const struct MemoryWatchpointEvent *event, void *callback_context);
+
 /** Classes ***************************************************************/
 class MemoryStorage : public IStorageLocation {
 public:
@@ -46,6 +99,18 @@ public:
         is_mirror(false)
     {};
 
+    /* Constructor for creating a memory storage object viewing a buffer owned by someone else,
+     * such as a region of the address space buffer of the memory map.
+     * */
+    inline MemoryStorage(native_word_t *view_buffer, std::size_t num_storage_words):
+        IStorageLocation(), is_mirror(true)
+    {
+        ASSERT(nullptr != view_buffer);
+
+        this->storage_buffer = view_buffer;
+        this->storage_size = system_words_to_bytes(num_storage_words);
+    }
+
     /* Constructor for creating a mirror memory storage object.
      * Both this instance's storage buffer as well as the original storage buffer point to the same memory.
      * */
@@ -64,7 +129,7 @@ public:
 
     inline ~MemoryStorage()
     {
-        /* If this is not the original memory storage, but rather a mirror,
+        /* If this is not the original memory storage, but rather a mirror or a view,
          * set the buffer to nullptr in order to avoid a double free error.
          * */
         if (true == is_mirror) {
@@ -82,11 +147,201 @@ private:
 };
 
 
+/** @brief Memory storage of a writable region, which counts its writes in the write generation of the memory map.
+ *         The memory map compares the generation to the one it last froze its address space at,
+ *         so that telling whether the address space changed since does not depend on its size.
+ * */
+class WriteCountingMemoryStorage : public MemoryStorage {
+public:
+    inline WriteCountingMemoryStorage(
+        native_word_t *view_buffer,
+        std::size_t num_storage_words,
+        std::uint64_t *write_generation
+    ): MemoryStorage(view_buffer, num_storage_words), write_generation(write_generation)
+    {
+        ASSERT(nullptr != write_generation);
+    }
+
+    enum PeNESStatus write(
+        const native_word_t *write_buffer,
+        std::size_t num_write_words,
+        std::size_t write_word_offset
+    ) override;
+
+private:
+    std::uint64_t *write_generation;
+};
+
+
+/** @brief Memory storage that marks every page it writes to in a dirty page bitmap.
+ *         Only writable regions are created as tracked storage, and only when dirty tracking is enabled,
+ *         so that untracked regions keep the plain write path.
+ * */
+class DirtyTrackingMemoryStorage : public WriteCountingMemoryStorage {
+public:
+    inline DirtyTrackingMemoryStorage(
+        native_word_t *view_buffer,
+        std::size_t num_storage_words,
+        std::uint64_t *write_generation,
+        native_address_t start_address,
+        std::bitset<MEMORY_MAP_NUM_PAGES> *dirty_pages
+    ):
+        WriteCountingMemoryStorage(view_buffer, num_storage_words, write_generation),
+        start_address(start_address),
+        dirty_pages(dirty_pages)
+    {
+        ASSERT(nullptr != dirty_pages);
+    }
+
+    enum PeNESStatus write(
+        const native_word_t *write_buffer,
+        std::size_t num_write_words,
+        std::size_t write_word_offset
+    ) override;
+
+private:
+    const native_address_t start_address;
+    std::bitset<MEMORY_MAP_NUM_PAGES> *dirty_pages;
+};
+
+
+/** @brief Memory storage of a PRG-ROM region, which views the bank selected into it.
+ *         Banks used in place are shared by every map built on the same loader, and a memory mapped image
+ *         is mapped read-only, and so writes are dropped instead of reaching the bank, as they are on a cartridge.
+ * */
+class ROMMemoryStorage : public MemoryStorage {
+public:
+    inline ROMMemoryStorage(native_word_t *view_buffer, std::size_t num_storage_words):
+        MemoryStorage(view_buffer, num_storage_words)
+    {}
+
+    enum PeNESStatus write(
+        const native_word_t *write_buffer,
+        std::size_t num_write_words,
+        std::size_t write_word_offset
+    ) override;
+};
+
+
+/** @brief Memory storage of an I/O register region, whose accesses are forwarded to the peripheral attached to it.
+ *         The peripheral is synchronized to the current cycle before every access, which is what lets peripherals
+ *         run lazily instead of in lockstep with the CPU.
+ *         Without an attached peripheral, the region behaves as plain memory.
+ * */
+class PeripheralMemoryStorage : public WriteCountingMemoryStorage {
+public:
+    inline PeripheralMemoryStorage(
+        native_word_t *view_buffer,
+        std::size_t num_storage_words,
+        std::uint64_t *write_generation,
+        native_address_t start_address
+    ): WriteCountingMemoryStorage(view_buffer, num_storage_words, write_generation), start_address(start_address)
+    {}
+
+    /** @brief          Forward the accesses to the region to a peripheral.
+     *
+     *  @param[in]      peripheral                  The peripheral to forward to.
+     *  @param[in]      cycle_counter               The CPU cycle counter to synchronize the peripheral to.
+     *  @param[in]      register_base_address       The address of the peripheral's first register.
+     *  @param[in]      num_registers               The number of registers, past which addresses are mirrors.
+     * */
+    inline void attach_peripheral(
+        IPeripheral *peripheral,
+        const std::uint64_t *cycle_counter,
+        native_address_t register_base_address,
+        std::size_t num_registers
+    )
+    {
+        ASSERT(nullptr != peripheral);
+        ASSERT(nullptr != cycle_counter);
+        ASSERT(0 < num_registers);
+
+        this->peripheral = peripheral;
+        this->cycle_counter = cycle_counter;
+        this->register_base_address = register_base_address;
+        this->num_registers = num_registers;
+    }
+
+    enum PeNESStatus read(
+        native_word_t *read_buffer,
+        std::size_t num_read_words,
+        std::size_t read_word_offset
+    ) override;
+
+    enum PeNESStatus write(
+        const native_word_t *write_buffer,
+        std::size_t num_write_words,
+        std::size_t write_word_offset
+    ) override;
+
+private:
+    /** @brief Retrieve the register an offset within the region refers to, folding the register mirrors. */
+    inline native_address_t get_register_address(std::size_t word_offset) const
+    {
+        return this->register_base_address +
+               (this->start_address + word_offset - this->register_base_address) % this->num_registers;
+    }
+
+    const native_address_t start_address;
+    IPeripheral *peripheral = nullptr;
+    const std::uint64_t *cycle_counter = nullptr;
+    native_address_t register_base_address = 0;
+    std::size_t num_registers = 0;
+};
+
+
+class MemoryMap;
+
+
+/** @brief Memory storage standing in for a region in the pages that contain watchpoints.
+ *         Accesses are forwarded to the region's storage and then reported to the memory map,
+ *         which invokes the callbacks of the watchpoints matching the accessed addresses.
+ *         Pages without watchpoints refer to the region's storage directly and never reach this class.
+ * */
+class WatchpointMemoryStorage : public MemoryStorage {
+public:
+    inline WatchpointMemoryStorage(
+        MemoryStorage *region_storage,
+        native_address_t start_address,
+        const MemoryMap *memory_map
+    ): MemoryStorage(), region_storage(region_storage), start_address(start_address), memory_map(memory_map)
+    {
+        ASSERT(nullptr != region_storage);
+        ASSERT(nullptr != memory_map);
+    }
+
+    enum PeNESStatus read(
+        native_word_t *read_buffer,
+        std::size_t num_read_words,
+        std::size_t read_word_offset
+    ) override;
+
+    enum PeNESStatus write(
+        const native_word_t *write_buffer,
+        std::size_t num_write_words,
+        std::size_t write_word_offset
+    ) override;
+
+private:
+    MemoryStorage *region_storage;
+    const native_address_t start_address;
+    const MemoryMap *memory_map;
+};
+
+
 class MemoryMap {
 public:
-     MemoryMap();
+     explicit MemoryMap(bool is_dirty_tracking_enabled = false);
+
+     explicit MemoryMap(ROMLoader *rom_loader, bool is_dirty_tracking_enabled = false);
 
-     explicit MemoryMap(ROMLoader *rom_loader);
+     /** @brief          Construct a map of the same ROM as another map, with the same PRG-ROM banks selected,
+      *                  sharing every bank the other map has loaded rather than loading it again.
+      *                  The address space is fresh, to be copied by clone_address_space.
+      *
+      *  @param[in]      source_memory_map           The map to share the banks of.
+      * */
+     explicit MemoryMap(const MemoryMap *source_memory_map);
 
      inline ~MemoryMap()
      {
@@ -95,25 +350,66 @@ public:
          delete this->nmi_jump_vector_storage;
          delete this->reset_jump_vector_storage;
 
+         /* Delete all watchpoint storage objects standing in for regions. */
+         for (WatchpointMemoryStorage *watchpoint_storage : this->watchpoint_storage_table) {
+             delete watchpoint_storage;
+         }
+
+         this->watchpoint_storage_table.clear();
+
          /* Delete all memory storage objects saved within the memory map. */
          for (MemoryStorage *memory_storage : this->storage_table) {
              delete memory_storage;
          }
 
          this->storage_table.clear();
+
+         /* Release the buffer the regions were viewing, writing back the battery-backed SRAM first. */
+         this->release_address_space();
      }
 
-    enum PeNESStatus get_memory_storage(
+    /** @brief          Retrieve the storage object of the region containing an address, for a data access.
+     *                  Addresses in pages containing watchpoints resolve to a storage that reports the access.
+     *
+     *  @param[in]      address                     The address to resolve.
+     *  @param[out]     output_storage              The storage object containing the address.
+     *  @param[out]     output_storage_offset       The offset of the address within the storage object.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    inline enum PeNESStatus get_memory_storage(
         native_address_t address,
         MemoryStorage **output_storage,
         std::size_t *output_storage_offset = nullptr
-    ) const;
+    ) const
+    {
+        return this->find_storage(address, true, output_storage, output_storage_offset);
+    }
 
+    /** @brief          Retrieve the storage object of the region containing an address, for an instruction fetch.
+     *                  Instruction fetches are not data accesses, and so they always resolve to the region's storage.
+     *
+     *  @param[in]      address                     The address to resolve.
+     *  @param[out]     output_storage              The storage object containing the address.
+     *  @param[out]     output_storage_offset       The offset of the address within the storage object.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    inline enum PeNESStatus get_instruction_storage(
+        native_address_t address,
+        MemoryStorage **output_storage,
+        std::size_t *output_storage_offset = nullptr
+    ) const
+    {
+        return this->find_storage(address, false, output_storage, output_storage_offset);
+    }
+
+    /** @brief Retrieve the stack storage, which starts at the first address of the stack page. */
     inline MemoryStorage *get_stack() const
     {
-        ASSERT(nullptr != this->stack_storage);
+        ASSERT(nullptr != this->page_table[MEMORY_MAP_ADDRESS_TO_PAGE(MEMORY_MAP_ADDRESS_START_STACK)].storage);
 
-        return this->stack_storage;
+        return this->page_table[MEMORY_MAP_ADDRESS_TO_PAGE(MEMORY_MAP_ADDRESS_START_STACK)].storage;
     }
 
     inline MemoryStorage *get_irq_jump_vector() const
@@ -137,13 +433,393 @@ public:
         return this->reset_jump_vector_storage;
     }
 
+    inline bool is_dirty_tracking_enabled() const
+    {
+        return this->dirty_tracking_enabled;
+    }
+
+    /** @brief Check whether the page has been written to since the dirty pages were last cleared. */
+    inline bool is_page_dirty(std::size_t page_index) const
+    {
+        ASSERT(MEMORY_MAP_NUM_PAGES > page_index);
+
+        return this->dirty_pages.test(page_index);
+    }
+
+    /** @brief Retrieve the bitmap of pages written to since the dirty pages were last cleared, indexed by page. */
+    inline const std::bitset<MEMORY_MAP_NUM_PAGES>& get_dirty_pages() const
+    {
+        return this->dirty_pages;
+    }
+
+    inline void clear_dirty_pages()
+    {
+        this->dirty_pages.reset();
+    }
+
+    /** @brief          Copy the whole address space into a snapshot buffer.
+     *                  All regions are views into a single buffer, and so this is a single contiguous copy.
+     *
+     *  @param[out]     snapshot_buffer             A buffer of MEMORY_MAP_ADDRESS_SPACE_SIZE words.
+     *
+     *  @note           The selected PRG-ROM banks are outside of the buffer, and so are not part of the snapshot.
+     * */
+    inline void save_snapshot(native_word_t *snapshot_buffer) const
+    {
+        ASSERT(nullptr != snapshot_buffer);
+
+        COPY_MEMORY(snapshot_buffer, this->address_space_buffer, MEMORY_MAP_ADDRESS_SPACE_SIZE);
+    }
+
+    /** @brief          Restore the whole address space from a snapshot buffer.
+     *
+     *  @param[in]      snapshot_buffer             A buffer of MEMORY_MAP_ADDRESS_SPACE_SIZE words,
+     *                                              previously filled by save_snapshot.
+     *
+     *  @note           Restoring bypasses the regions' write paths, and so all pages are marked dirty
+     *                  and no watchpoints are reported.
+     * */
+    inline void load_snapshot(const native_word_t *snapshot_buffer)
+    {
+        ASSERT(nullptr != snapshot_buffer);
+
+        COPY_MEMORY(this->address_space_buffer, snapshot_buffer, MEMORY_MAP_ADDRESS_SPACE_SIZE);
+        this->write_generation++;
+
+        if (true == this->dirty_tracking_enabled) {
+            this->dirty_pages.set();
+        }
+    }
+
+    /** @brief          Make the address space a copy-on-write copy of another map's, and select the same PRG-ROM banks.
+     *                  The contents of the other map are frozen into an image that both maps privately map,
+     *                  and so the pages are shared until either map writes to one, which copies that page alone.
+     *                  The image is kept by the other map, and reused by its later clones until it writes.
+     *                  The PRG-ROM banks are shared as well, being views into the same ROM image.
+     *
+     *  @param[in]      source_memory_map           The map to copy, which must use the same ROM loader.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           This map must be fresh, without a battery-backed SRAM, watchpoints, attached peripherals
+     *                  or a memory profiler. None of those are copied from the source.
+     *                  The SRAM of the copy is private, even if the source's is backed by a save file.
+     *                  The image is a plain memfd, which the kernel backs with small pages unless its shmem
+     *                  transparent huge pages are enabled, and so both maps may lose the huge page that
+     *                  PENES_HUGE_PAGES allocated the address space as. A huge page would have to be copied
+     *                  whole by the first write to it, where small pages only copy the page written to.
+     * */
+    enum PeNESStatus clone_address_space(MemoryMap *source_memory_map);
+
+    inline ROMLoader *get_rom_loader() const
+    {
+        return this->rom_loader;
+    }
+
+    /** @brief          Back the SRAM region with a save file, so that battery-backed saves persist across runs.
+     *                  The file is mapped directly as the region's buffer, and so writes to the SRAM
+     *                  reach the file without being copied out.
+     *
+     *  @param[in]      save_file                   The path of the save file, created if it does not exist.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           The previous SRAM contents are replaced by the contents of the save file.
+     * */
+    enum PeNESStatus map_battery_sram(const std::string& save_file);
+
+    /** @brief          Write the battery-backed SRAM back to its save file.
+     *
+     *  @param[in]      is_blocking                 Whether to wait for the write to complete.
+     *                                              Non-blocking flushes only schedule the write-back,
+     *                                              and so are cheap enough to issue at every frame boundary.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus flush_battery_sram(bool is_blocking);
+
+    inline bool is_battery_sram_mapped() const
+    {
+        return nullptr != this->battery_sram_storage;
+    }
+
+    /** @brief          Watch accesses to an address.
+     *                  Only the page containing the address is diverted to the watched access path,
+     *                  the rest of the address space keeps resolving directly to the region storage objects.
+     *
+     *  @param[in]      address                     The address to watch.
+     *  @param[in]      watchpoint_type             The types of accesses to report.
+     *  @param[in]      callback                    The function to call for every matching access.
+     *  @param[in]      callback_context            An opaque pointer passed to the callback.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Adding a watchpoint to an already watched address replaces it.
+     * */
+    enum PeNESStatus add_watchpoint(
+        native_address_t address,
+        enum MemoryWatchpointType watchpoint_type,
+        memory_watchpoint_callback_t callback,
+        void *callback_context = nullptr
+    );
+
+    /** @brief          Stop watching accesses to an address.
+     *
+     *  @param[in]      address                     The watched address.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus remove_watchpoint(native_address_t address);
+
+    /** @brief Record the address of the instruction being executed, to be reported by watchpoints. */
+    inline void set_instruction_address(native_address_t instruction_address)
+    {
+        this->instruction_address = instruction_address;
+
+#ifdef PENES_MEMORY_PROFILER
+        if (nullptr != this->memory_profiler) {
+            this->memory_profiler->record_access(
+                instruction_address,
+                this->get_prg_rom_bank_index(instruction_address),
+                MEMORY_PROFILER_ACCESS_TYPE_EXECUTE,
+                1
+            );
+        }
+#endif
+    }
+
+    /** @brief          Retrieve the index of the PRG-ROM bank mapped at an address.
+     *
+     *  @param[in]      address                     The address within the PRG-ROM.
+     *
+     *  @return         The bank index, or MEMORY_MAP_PRG_ROM_BANK_NONE if no bank is mapped at the address.
+     * */
+    inline std::size_t get_prg_rom_bank_index(native_address_t address) const
+    {
+        if (MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER > address) {
+            return MEMORY_MAP_PRG_ROM_BANK_NONE;
+        }
+
+        return this->prg_rom_bank_indices[(MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER > address)? 0: 1];
+    }
+
+    /** @brief          Select the PRG-ROM bank mapped at a PRG-ROM slot, as done by the cartridge mapper.
+     *                  A bank is only loaded the first time it is selected, and stays resident from then on,
+     *                  so that switching to it again is only a change of the slot's buffer.
+     *
+     *  @param[in]      prg_rom_address             The start of the slot, either the lower or the upper PRG-ROM bank.
+     *  @param[in]      bank_index                  The index of the bank within the ROM.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus select_prg_rom_bank(enum MemoryMapAddress prg_rom_address, std::size_t bank_index);
+
+    /** @brief Retrieve the residency of every PRG-ROM bank of the ROM, indexed by bank. */
+    inline const std::vector<struct MemoryMapPRGROMBankStats>& get_prg_rom_bank_stats() const
+    {
+        return this->prg_rom_bank_stats;
+    }
+
+    inline std::size_t get_num_resident_prg_rom_banks() const
+    {
+        return this->num_resident_prg_rom_banks;
+    }
+
+#ifdef PENES_MEMORY_PROFILER
+    /** @brief          Count every data access and executed instruction with a memory profiler.
+     *                  All pages are diverted to the watched access path, which reports to the profiler.
+     *
+     *  @param[in]      memory_profiler             The profiler to count accesses with.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus attach_memory_profiler(MemoryProfiler *memory_profiler);
+#endif
+
+    /** @brief          Attach a peripheral to an I/O register region, so that it is synchronized and accessed
+     *                  whenever the CPU touches its registers.
+     *
+     *  @param[in]      io_address                  The start of the region, either MEMORY_MAP_ADDRESS_START_IO_REGISTERS
+     *                                              for the PPU registers along with their mirrors,
+     *                                              or MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2 for the APU and I/O registers.
+     *  @param[in]      peripheral                  The peripheral to attach.
+     *  @param[in]      cycle_counter               The CPU cycle counter to synchronize the peripheral to.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Register accesses synchronize the peripheral to the cycle the accessing instruction started on.
+     * */
+    enum PeNESStatus attach_peripheral(
+        enum MemoryMapAddress io_address,
+        IPeripheral *peripheral,
+        const std::uint64_t *cycle_counter
+    );
+
+    /** @brief          Synchronize every attached peripheral to a cycle, such as when a scheduled event is due.
+     *
+     *  @param[in]      target_cycle                The cycle to run to, counted since power on.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    inline enum PeNESStatus sync_peripherals(std::uint64_t target_cycle)
+    {
+        enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+        for (IPeripheral *peripheral : this->peripherals) {
+            status = peripheral->sync(target_cycle);
+            if (PENES_STATUS_SUCCESS != status) {
+                DEBUG_PRINT_WITH_ARGS("sync failed. Status: %d.\n", status);
+                goto l_cleanup;
+            }
+        }
+
+        status = PENES_STATUS_SUCCESS;
+    l_cleanup:
+        return status;
+    }
+
+    /** @brief          Invoke the callbacks of the watchpoints matching an access.
+     *
+     *  @param[in]      address                     The address of the first accessed word.
+     *  @param[in]      access_buffer               The words that were read or written.
+     *  @param[in]      num_access_words            The number of accessed words.
+     *  @param[in]      access_type                 Whether the access is a read or a write.
+     * */
+    void notify_watchpoints(
+        native_address_t address,
+        const native_word_t *access_buffer,
+        std::size_t num_access_words,
+        enum MemoryWatchpointType access_type
+    ) const;
+
 private:
+    /** @brief Mapping of a single page of the address space to the storage object of the region containing it. */
+    struct Page {
+        /* The storage to use for data accesses, or nullptr if the page is split between multiple regions. */
+        MemoryStorage *storage;
+        /* The storage of the region itself, or nullptr if the page is split between multiple regions. */
+        MemoryStorage *region_storage;
+        /* The offset of the first address of the page within the region storage. */
+        std::size_t storage_offset;
+    };
+
+    struct Watchpoint {
+        enum MemoryWatchpointType watchpoint_type;
+        memory_watchpoint_callback_t callback;
+        void *callback_context;
+    };
+
+    enum PeNESStatus find_storage(
+        native_address_t address,
+        bool is_data_access,
+        MemoryStorage **output_storage,
+        std::size_t *output_storage_offset
+    ) const;
+
+    enum PeNESStatus find_region(
+        native_address_t address,
+        std::size_t *output_region_index,
+        std::size_t *output_region_offset
+    ) const;
+
+    enum PeNESStatus setup_page_table();
+
+    void create_watchpoint_storage(std::size_t region_index);
+
+    enum PeNESStatus allocate_address_space();
+
+    void release_address_space();
+
+    /** @brief          Copy the address space into a new image, and remap the address space as a private mapping of it.
+     *                  The contents are unchanged, but the pages are shared with the image until written.
+     *                  An address space that was not written since it was last frozen is not copied again.
+     *
+     *  @param[out]     output_image_descriptor     A descriptor of the image, which is owned by the map.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus freeze_address_space(int *output_image_descriptor);
+
+    void release_frozen_image();
+
+    /** @brief          Map a range of an address space image privately over the same range of the address space.
+     *
+     *  @param[in]      image_descriptor            A descriptor of the image.
+     *  @param[in]      start_address               The start of the range, aligned to a host page.
+     *  @param[in]      num_words                   The size of the range, aligned to a host page.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus map_address_space_image(int image_descriptor, std::size_t start_address, std::size_t num_words);
+
+    enum PeNESStatus watch_page(std::size_t page_index);
+
     enum PeNESStatus setup_storage_shortcuts();
 
+    enum PeNESStatus load_prg_rom_bank(std::size_t bank_index, native_word_t **output_bank);
+
+    enum PeNESStatus attach_peripheral_storage(
+        enum MemoryMapAddress region_address,
+        IPeripheral *peripheral,
+        const std::uint64_t *cycle_counter,
+        native_address_t register_base_address,
+        std::size_t num_registers
+    );
+
     static const std::vector<enum MemoryMapAddress> address_keys;
+    static const std::vector<enum MemoryMapAddress> dirty_tracking_address_keys;
+    static const std::vector<enum MemoryMapAddress> peripheral_address_keys;
+    static const std::vector<enum MemoryMapAddress> prg_rom_address_keys;
     std::vector<MemoryStorage *> storage_table;
 
-    MemoryStorage *stack_storage = nullptr;
+    /* The buffer backing the whole address space, which every region is a view into. */
+    native_word_t *address_space_buffer = nullptr;
+    std::size_t address_space_mapping_size = 0;
+
+    /* The number of writes to the address space, counted by the storage objects of the writable regions. */
+    std::uint64_t write_generation = 0;
+
+    /* The image the address space was last frozen into, along with the write generation it was frozen at,
+     * which every clone of the map shares for as long as the address space is not written.
+     * */
+    int frozen_image_descriptor = -1;
+    std::uint64_t frozen_write_generation = 0;
+
+    std::array<struct Page, MEMORY_MAP_NUM_PAGES> page_table;
+
+    const bool dirty_tracking_enabled;
+    std::bitset<MEMORY_MAP_NUM_PAGES> dirty_pages;
+
+    std::unordered_map<native_address_t, struct Watchpoint> watchpoints;
+    std::array<std::size_t, MEMORY_MAP_NUM_PAGES> num_page_watchpoints = {};
+    std::bitset<MEMORY_MAP_NUM_PAGES> watched_pages;
+    std::vector<WatchpointMemoryStorage *> watchpoint_storage_table;
+    native_address_t instruction_address = 0;
+
+    MemoryStorage *battery_sram_storage = nullptr;
+
+    /* The attached peripherals, each synchronized when a scheduled event is due. */
+    std::vector<IPeripheral *> peripherals;
+
+    std::array<std::size_t, MEMORY_MAP_NUM_PRG_ROM_SLOTS> prg_rom_bank_indices = {
+        {MEMORY_MAP_PRG_ROM_BANK_NONE, MEMORY_MAP_PRG_ROM_BANK_NONE}
+    };
+
+    /* The loader the PRG-ROM banks are loaded from, on their first selection. */
+    ROMLoader *rom_loader = nullptr;
+    /* The buffer of each resident bank, or nullptr for banks that have not been loaded yet.
+     * Banks of a ROM image used in place are not copied, other banks are copied into prg_rom_bank_copies,
+     * which are shared with the clones of the map, and so live for as long as any of them does.
+     * */
+    std::vector<native_word_t *> prg_rom_banks;
+    std::vector<std::shared_ptr<const std::vector<native_word_t>>> prg_rom_bank_copies;
+    std::vector<struct MemoryMapPRGROMBankStats> prg_rom_bank_stats;
+    std::size_t num_resident_prg_rom_banks = 0;
+
+#ifdef PENES_MEMORY_PROFILER
+    MemoryProfiler *memory_profiler = nullptr;
+#endif
+
     MemoryStorage *irq_jump_vector_storage = nullptr;
     MemoryStorage *nmi_jump_vector_storage = nullptr;
     MemoryStorage *reset_jump_vector_storage = nullptr;
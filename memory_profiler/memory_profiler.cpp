@@ -0,0 +1,93 @@
+/**
+ * @brief  Guest memory access heatmap profiler.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <string>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "memory_profiler/memory_profiler.h"
+
+/** Constants *************************************************************/
+#define MEMORY_PROFILER_CSV_HEADER ("space,bank,address,reads,writes,executes")
+#define MEMORY_PROFILER_CSV_ADDRESS_DIGITS (4)
+
+/** Functions *************************************************************/
+/** @brief Write a single heatmap row, unless nothing has accessed the address. */
+static void write_csv_row(
+    std::ofstream& output_stream,
+    const char *space_name,
+    const std::string& bank_field,
+    std::size_t address,
+    const memory_profiler_access_counts_t& access_counts
+)
+{
+    if ((0 == access_counts[MEMORY_PROFILER_ACCESS_TYPE_READ]) &&
+        (0 == access_counts[MEMORY_PROFILER_ACCESS_TYPE_WRITE]) &&
+        (0 == access_counts[MEMORY_PROFILER_ACCESS_TYPE_EXECUTE])) {
+        return;
+    }
+
+    output_stream << space_name << ',' << bank_field << ",0x"
+                  << std::hex << std::uppercase
+                  << std::setw(MEMORY_PROFILER_CSV_ADDRESS_DIGITS) << std::setfill('0') << address
+                  << std::dec << ','
+                  << access_counts[MEMORY_PROFILER_ACCESS_TYPE_READ] << ','
+                  << access_counts[MEMORY_PROFILER_ACCESS_TYPE_WRITE] << ','
+                  << access_counts[MEMORY_PROFILER_ACCESS_TYPE_EXECUTE] << '\n';
+}
+
+
+enum PeNESStatus MemoryProfiler::dump_csv(const std::string& output_file) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ofstream output_stream;
+    std::size_t address = 0;
+    std::size_t bank_index = 0;
+    std::size_t bank_offset = 0;
+
+    output_stream.open(output_file, std::ofstream::out | std::ofstream::trunc);
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_MEMORY_PROFILER_DUMP_CSV_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Failed to open heatmap file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    output_stream << MEMORY_PROFILER_CSV_HEADER << '\n';
+
+    /* Dump the counts of the whole address space, regardless of the mapped banks. */
+    for (address = 0; address < MEMORY_PROFILER_NUM_ADDRESSES; address++) {
+        write_csv_row(output_stream, "cpu", "", address, this->address_access_counts[address]);
+    }
+
+    /* Dump the counts of each PRG-ROM bank, addressed by the offset within the bank. */
+    for (bank_index = 0; bank_index < this->num_prg_rom_banks; bank_index++) {
+        for (bank_offset = 0; bank_offset < MEMORY_PROFILER_PRG_ROM_BANK_SIZE; bank_offset++) {
+            write_csv_row(
+                output_stream,
+                "prg",
+                std::to_string(bank_index),
+                bank_offset,
+                this->prg_rom_bank_access_counts[(bank_index * MEMORY_PROFILER_PRG_ROM_BANK_SIZE) + bank_offset]
+            );
+        }
+    }
+
+    output_stream.flush();
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_MEMORY_PROFILER_DUMP_CSV_WRITE_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Failed to write heatmap file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
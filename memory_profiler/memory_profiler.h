@@ -0,0 +1,103 @@
+/**
+ * @brief  Guest memory access heatmap profiler.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __MEMORY_PROFILER_H__
+#define __MEMORY_PROFILER_H__
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "penes_status.h"
+#include "system.h"
+
+/** Constants *************************************************************/
+#define MEMORY_PROFILER_NUM_ADDRESSES (0x10000)
+#define MEMORY_PROFILER_ADDRESS_MASK (MEMORY_PROFILER_NUM_ADDRESSES - 1)
+#define MEMORY_PROFILER_PRG_ROM_BANK_SIZE (0x4000)
+#define MEMORY_PROFILER_PRG_ROM_BANK_OFFSET_MASK (MEMORY_PROFILER_PRG_ROM_BANK_SIZE - 1)
+#define MEMORY_PROFILER_PRG_ROM_BANK_NONE (SIZE_MAX)
+
+/** Enums *****************************************************************/
+enum MemoryProfilerAccessType {
+    MEMORY_PROFILER_ACCESS_TYPE_NONE = -1,
+    MEMORY_PROFILER_ACCESS_TYPE_READ = 0,
+    MEMORY_PROFILER_ACCESS_TYPE_WRITE,
+    MEMORY_PROFILER_ACCESS_TYPE_EXECUTE,
+    MEMORY_PROFILER_ACCESS_TYPE_MAX
+};
+
+/** Typedefs **************************************************************/
+typedef std::array<std::uint64_t, MEMORY_PROFILER_ACCESS_TYPE_MAX> memory_profiler_access_counts_t;
+
+/** Classes ***************************************************************/
+class MemoryProfiler {
+public:
+    /** @brief          Initialize the profiler with zeroed access counts.
+     *
+     *  @param[in]      num_prg_rom_banks           The number of PRG-ROM banks in the loaded ROM,
+     *                                              each of which is counted separately.
+     * */
+    inline explicit MemoryProfiler(std::size_t num_prg_rom_banks):
+        num_prg_rom_banks(num_prg_rom_banks),
+        address_access_counts(MEMORY_PROFILER_NUM_ADDRESSES),
+        prg_rom_bank_access_counts(num_prg_rom_banks * MEMORY_PROFILER_PRG_ROM_BANK_SIZE)
+    {}
+
+    /** @brief          Count an access to consecutive guest addresses.
+     *
+     *  @param[in]      address                     The first accessed address.
+     *  @param[in]      prg_rom_bank_index          The PRG-ROM bank mapped at the address,
+     *                                              or MEMORY_PROFILER_PRG_ROM_BANK_NONE outside of PRG-ROM.
+     *  @param[in]      access_type                 The type of the access.
+     *  @param[in]      num_access_words            The number of accessed words.
+     * */
+    inline void record_access(
+        native_address_t address,
+        std::size_t prg_rom_bank_index,
+        enum MemoryProfilerAccessType access_type,
+        std::size_t num_access_words
+    )
+    {
+        std::size_t word_index = 0;
+        std::size_t word_address = 0;
+
+        for (word_index = 0; word_index < num_access_words; word_index++) {
+            word_address = (address + word_index) & MEMORY_PROFILER_ADDRESS_MASK;
+            this->address_access_counts[word_address][access_type]++;
+
+            if (this->num_prg_rom_banks > prg_rom_bank_index) {
+                this->prg_rom_bank_access_counts[
+                    (prg_rom_bank_index * MEMORY_PROFILER_PRG_ROM_BANK_SIZE) +
+                    (word_address & MEMORY_PROFILER_PRG_ROM_BANK_OFFSET_MASK)
+                ][access_type]++;
+            }
+        }
+    }
+
+    /** @brief          Write the non-zero access counts as a CSV heatmap.
+     *
+     *  @param[in]      output_file                 The path of the CSV file to create.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Each row holds the reads, writes and executes of a single address.
+     *                  Rows of the "cpu" space are indexed by guest address,
+     *                  rows of the "prg" space by PRG-ROM bank and offset within the bank.
+     * */
+    enum PeNESStatus dump_csv(const std::string& output_file) const;
+
+private:
+    const std::size_t num_prg_rom_banks;
+    std::vector<memory_profiler_access_counts_t> address_access_counts;
+    std::vector<memory_profiler_access_counts_t> prg_rom_bank_access_counts;
+};
+
+
+#endif /* __MEMORY_PROFILER_H__ */
@@ -14,11 +14,12 @@ enum PeNESStatus {
     PENES_STATUS_SUCCESS = 0,
 
     /* Error statuses for the module utils. */
-    PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_CREATE_INSTANCE_OUT_OF_BOUNDS,
-    PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_CREATE_INSTANCE_INVALID_FUNCTION,
+    PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_GET_INSTANCE_OUT_OF_BOUNDS,
+    PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_GET_INSTANCE_INVALID_FUNCTION,
     PENES_STATUS_UTILS_OBJECT_TABLE_GET_TYPE_OUT_OF_BOUNDS,
     PENES_STATUS_UTILS_OBJECT_TABLE_GET_OBJECT_OUT_OF_BOUNDS,
     PENES_STATUS_UTILS_OBJECT_TABLE_GET_OBJECT_BY_TYPE_NOT_FOUND,
+    PENES_STATUS_UTILS_PARSE_SIZE_INVALID,
 
     /* Error statuses for the module decoder. */
     PENES_STATUS_DECODER_DECODE_OPCODE_ADDRESS_OUT_OF_BOUNDS,
@@ -28,6 +29,29 @@ enum PeNESStatus {
     /* Error statuses for the module memory_map. */
     PENES_STATUS_MEMORY_MAP_GET_MEMORY_STORAGE_NOT_FOUND,
     PENES_STATUS_MEMORY_MAP_GET_MEMORY_STORAGE_OUT_OF_BOUNDS,
+    PENES_STATUS_MEMORY_MAP_ADD_WATCHPOINT_INVALID_TYPE,
+    PENES_STATUS_MEMORY_MAP_REMOVE_WATCHPOINT_NOT_FOUND,
+    PENES_STATUS_MEMORY_MAP_ALLOCATE_ADDRESS_SPACE_MMAP_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_ALREADY_MAPPED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_GET_STORAGE_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_OPEN_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_FSTAT_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_FTRUNCATE_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_BATTERY_SRAM_MMAP_FAILED,
+    PENES_STATUS_MEMORY_MAP_FLUSH_BATTERY_SRAM_NOT_MAPPED,
+    PENES_STATUS_MEMORY_MAP_FLUSH_BATTERY_SRAM_MSYNC_FAILED,
+    PENES_STATUS_MEMORY_MAP_SELECT_PRG_ROM_BANK_INVALID_ADDRESS,
+    PENES_STATUS_MEMORY_MAP_SELECT_PRG_ROM_BANK_OUT_OF_BOUNDS,
+    PENES_STATUS_MEMORY_MAP_ATTACH_PERIPHERAL_INVALID_ADDRESS,
+    PENES_STATUS_MEMORY_MAP_CLONE_ADDRESS_SPACE_NOT_FRESH,
+    PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_MEMFD_CREATE_FAILED,
+    PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_FTRUNCATE_FAILED,
+    PENES_STATUS_MEMORY_MAP_FREEZE_ADDRESS_SPACE_PWRITE_FAILED,
+    PENES_STATUS_MEMORY_MAP_MAP_ADDRESS_SPACE_IMAGE_MMAP_FAILED,
+
+    /* Error statuses for the module memory_profiler. */
+    PENES_STATUS_MEMORY_PROFILER_DUMP_CSV_OPEN_FAILED,
+    PENES_STATUS_MEMORY_PROFILER_DUMP_CSV_WRITE_FAILED,
 
     /* Error statuses for the module storage_location. */
     PENES_STATUS_STORAGE_LOCATION_READ_OUT_OF_BOUNDS,
@@ -36,17 +60,78 @@ enum PeNESStatus {
 
     /* Error statuses for the module rom_loader. */
     PENES_STATUS_ROM_LOADER_OPEN_OPEN_FAILED,
-    PENES_STATUS_ROM_LOADER_OPEN_READ_MAGIC_FAILED,
-    PENES_STATUS_ROM_LOADER_OPEN_INVALID_FILE,
-    PENES_STATUS_ROM_LOADER_OPEN_GET_PRG_ROM_BANKS_LSB_FAILED,
-    PENES_STATUS_ROM_LOADER_OPEN_GET_CHR_ROM_BANKS_LSB_FAILED,
-    PENES_STATUS_ROM_LOADER_OPEN_SEEK_BANK_COUNT_FAILED,
-    PENES_STATUS_ROM_LOADER_OPEN_READ_ROM_BANK_MSB_FAILED,
+    PENES_STATUS_ROM_LOADER_OPEN_GET_FILE_SIZE_FAILED,
+    PENES_STATUS_ROM_LOADER_OPEN_READ_HEADER_FAILED,
+    PENES_STATUS_ROM_LOADER_PARSE_HEADER_INVALID_MAGIC,
+    PENES_STATUS_ROM_LOADER_PARSE_HEADER_INVALID_ROM_SIZE,
+    PENES_STATUS_ROM_LOADER_SETUP_BANKS_TRUNCATED_FILE,
     PENES_STATUS_LOADER_SEEK_PRG_ROM_FAILED,
     PENES_STATUS_LOADER_READ_PRG_ROM_FAILED,
     PENES_STATUS_LOADER_GET_PRG_ROM_BANK_OUT_OF_BOUNDS,
     PENES_STATUS_LOADER_GET_PRG_ROM_BANK_SEEKG_FAILED,
     PENES_STATUS_LOADER_GET_PRG_ROM_BANK_READ_FAILED,
+    PENES_STATUS_ROM_LOADER_MAP_PRG_ROM_BANK_NOT_MAPPED,
+    PENES_STATUS_ROM_LOADER_MAP_PRG_ROM_BANK_OUT_OF_BOUNDS,
+    PENES_STATUS_ROM_LOADER_MAP_FILE_OPEN_FAILED,
+    PENES_STATUS_ROM_LOADER_MAP_FILE_FSTAT_FAILED,
+    PENES_STATUS_ROM_LOADER_MAP_FILE_TRUNCATED_FILE,
+    PENES_STATUS_ROM_LOADER_MAP_FILE_MMAP_FAILED,
+    PENES_STATUS_ROM_LOADER_LOAD_CHR_ROM_SEEKG_FAILED,
+    PENES_STATUS_ROM_LOADER_LOAD_CHR_ROM_READ_FAILED,
+    PENES_STATUS_ROM_LOADER_OPEN_FROM_BUFFER_TRUNCATED_BUFFER,
+    PENES_STATUS_ROM_LOADER_OPEN_GZIP_FILE_TRUNCATED_FILE,
+
+    /* Error statuses for the module rom_index. */
+    PENES_STATUS_ROM_INDEX_ADD_FILE_OPEN_FAILED,
+    PENES_STATUS_ROM_INDEX_ADD_FILE_FSTAT_FAILED,
+    PENES_STATUS_ROM_INDEX_ADD_FILE_TRUNCATED_FILE,
+    PENES_STATUS_ROM_INDEX_ADD_FILE_MMAP_FAILED,
+    PENES_STATUS_ROM_INDEX_FIND_ROM_FILES_OPENDIR_FAILED,
+    PENES_STATUS_ROM_INDEX_FIND_ROM_FILES_FSTAT_FAILED,
+    PENES_STATUS_ROM_INDEX_SAVE_OPEN_FAILED,
+    PENES_STATUS_ROM_INDEX_SAVE_WRITE_FAILED,
+    PENES_STATUS_ROM_INDEX_LOAD_OPEN_FAILED,
+    PENES_STATUS_ROM_INDEX_LOAD_INVALID_FILE,
+    PENES_STATUS_ROM_INDEX_LOAD_UNSUPPORTED_VERSION,
+    PENES_STATUS_ROM_INDEX_LOAD_READ_FAILED,
+    PENES_STATUS_ROM_INDEX_FIND_ENTRY_NOT_FOUND,
+    PENES_STATUS_ROM_INDEX_FIND_ENTRY_STAT_FAILED,
+    PENES_STATUS_ROM_INDEX_FIND_ENTRY_STALE_ENTRY,
+    PENES_STATUS_ROM_INDEX_FIND_ENTRY_BY_HASH_NOT_FOUND,
+
+    /* Error statuses for the module rom_scanner. */
+    PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_STAT_FAILED,
+    PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_READ_HEADER_FAILED,
+    PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_TRUNCATED_FILE,
+    PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_INVALID_RESET_VECTOR,
+    PENES_STATUS_ROM_SCANNER_WRITE_REPORT_OPEN_FAILED,
+    PENES_STATUS_ROM_SCANNER_WRITE_REPORT_WRITE_FAILED,
+
+    /* Error statuses for the module gzip_reader. */
+    PENES_STATUS_GZIP_READER_OPEN_OPEN_FAILED,
+    PENES_STATUS_GZIP_READER_READ_MEMBER_HEADER_INVALID_MAGIC,
+    PENES_STATUS_GZIP_READER_READ_MEMBER_HEADER_UNSUPPORTED_METHOD,
+    PENES_STATUS_GZIP_READER_READ_INPUT_BYTE_TRUNCATED_FILE,
+    PENES_STATUS_GZIP_READER_READ_BLOCK_HEADER_INVALID_STORED_LENGTH,
+    PENES_STATUS_GZIP_READER_READ_BLOCK_HEADER_INVALID_TYPE,
+    PENES_STATUS_GZIP_READER_READ_DYNAMIC_CODES_INVALID_LENGTHS,
+    PENES_STATUS_GZIP_READER_BUILD_CODE_OVERSUBSCRIBED,
+    PENES_STATUS_GZIP_READER_DECODE_SYMBOL_INVALID_CODE,
+    PENES_STATUS_GZIP_READER_READ_INVALID_SYMBOL,
+    PENES_STATUS_GZIP_READER_READ_INVALID_DISTANCE,
+    PENES_STATUS_GZIP_READER_FINISH_CRC32_MISMATCH,
+    PENES_STATUS_GZIP_READER_FINISH_SIZE_MISMATCH,
+    PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_OPEN_FAILED,
+    PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_READ_FAILED,
+    PENES_STATUS_GZIP_READER_GET_DECOMPRESSED_SIZE_INVALID_SIZE,
+
+    /* Error statuses for the module cpu. */
+    PENES_STATUS_CPU_GET_MONOTONIC_TIME_CLOCK_GETTIME_FAILED,
+    PENES_STATUS_CPU_WAIT_UNTIL_CLOCK_NANOSLEEP_FAILED,
+
+    /* Error statuses for the module input_movie. */
+    PENES_STATUS_INPUT_MOVIE_LOAD_OPEN_FAILED,
+    PENES_STATUS_INPUT_MOVIE_PARSE_GAMEPAD_INVALID_FIELD,
 
     /* Error statuses for the module address_mode_interface. */
     PENES_STATUS_IMPLIED_ADDRESS_MODE_GET_STORAGE_INVALID_OPERATION,
@@ -0,0 +1,89 @@
+/**
+ * @brief  Interface of the memory-mapped peripherals, which are synchronized with the CPU lazily.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __PERIPHERAL_INTERFACE_H__
+#define __PERIPHERAL_INTERFACE_H__
+
+/** Headers ***************************************************************/
+#include <cstdint>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+/** Classes ***************************************************************/
+/** @brief A peripheral with registers in the I/O region, such as the PPU or the APU.
+ *         Rather than being stepped along with every CPU instruction, a peripheral records the last cycle it was
+ *         synchronized to, and only runs forward when the CPU accesses its registers or a scheduled event is due.
+ *         Anything a peripheral raises in between, such as an NMI at the start of vertical blank,
+ *         is scheduled ahead of time in the event scheduler, so that the CPU stops to synchronize it on time.
+ * */
+class IPeripheral {
+public:
+    inline virtual ~IPeripheral() = default;
+
+    /** @brief          Run the peripheral forward to a CPU cycle.
+     *
+     *  @param[in]      target_cycle                The cycle to run to, counted since power on.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Nothing runs if the peripheral is already synchronized to the cycle.
+     * */
+    inline enum PeNESStatus sync(std::uint64_t target_cycle)
+    {
+        enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+        if (target_cycle <= this->last_sync_cycle) {
+            status = PENES_STATUS_SUCCESS;
+            goto l_cleanup;
+        }
+
+        status = this->run_cycles(target_cycle - this->last_sync_cycle);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("run_cycles failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->last_sync_cycle = target_cycle;
+
+        status = PENES_STATUS_SUCCESS;
+    l_cleanup:
+        return status;
+    }
+
+    inline std::uint64_t get_last_sync_cycle() const
+    {
+        return this->last_sync_cycle;
+    }
+
+    /** @brief          Read a register of the peripheral. The peripheral is synchronized before it is accessed.
+     *
+     *  @param[in]      register_address            The address of the register, with mirrors folded.
+     *  @param[out]     output_data                 The value read.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    virtual enum PeNESStatus read_register(native_address_t register_address, native_word_t *output_data) = 0;
+
+    /** @brief          Write a register of the peripheral. The peripheral is synchronized before it is accessed.
+     *
+     *  @param[in]      register_address            The address of the register, with mirrors folded.
+     *  @param[in]      data                        The value written.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    virtual enum PeNESStatus write_register(native_address_t register_address, native_word_t data) = 0;
+
+protected:
+    /** @brief Emulate the peripheral for a number of CPU cycles, from the cycle it was last synchronized to. */
+    virtual enum PeNESStatus run_cycles(std::uint64_t num_cycles) = 0;
+
+private:
+    std::uint64_t last_sync_cycle = 0;
+};
+
+#endif /* __PERIPHERAL_INTERFACE_H__ */
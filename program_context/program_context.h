@@ -9,6 +9,7 @@
 
 /** Headers ***************************************************************/
 #include <cstddef>
+#include <cstdint>
 
 #include "penes_status.h"
 #include "system.h"
@@ -17,6 +18,7 @@
 #include "memory_map/memory_map.h"
 #include "utils/utils.h"
 #include "rom_loader/rom_loader.h"
+#include "event_scheduler/event_scheduler.h"
 
 /** Constants *************************************************************/
 #define PROGRAM_CONTEXT_REGISTER_A_INITIAL_VALUE (0)
@@ -97,15 +99,111 @@ private:
 /** Structs ***************************************************************/
 class ProgramContext {
 public:
-    inline explicit ProgramContext(ROMLoader *file_loader): memory_map(file_loader)
+    inline explicit ProgramContext(ROMLoader *file_loader, bool is_dirty_tracking_enabled = false):
+        memory_map(file_loader, is_dirty_tracking_enabled)
     {
         ASSERT(nullptr != file_loader);
     }
 
+    /** @brief Construct a context whose memory map shares the PRG-ROM banks of another map, for a clone. */
+    inline explicit ProgramContext(const MemoryMap *source_memory_map):
+        memory_map(source_memory_map)
+    {
+        ASSERT(nullptr != source_memory_map);
+    }
+
+    /** @brief Attach a peripheral to an I/O register region, synchronized to the CPU cycle counter.
+     *         See MemoryMap::attach_peripheral.
+     * */
+    inline enum PeNESStatus attach_peripheral(enum MemoryMapAddress io_address, IPeripheral *peripheral)
+    {
+        return this->memory_map.attach_peripheral(io_address, peripheral, &this->num_cycles);
+    }
+
+    /** @brief          Create a copy of the context, whose address space is shared copy-on-write with this one's.
+     *                  See MemoryMap::clone_address_space.
+     *
+     *  @param[out]     output_clone                The copy, to be deleted by the caller.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Peripherals are not copied, and should be attached to the copy by the caller.
+     * */
+    inline enum PeNESStatus clone(ProgramContext **output_clone)
+    {
+        enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+        ProgramContext *clone_ctx = nullptr;
+
+        ASSERT(nullptr != output_clone);
+
+        /* The PRG-ROM banks this context has loaded are shared rather than read from the ROM again. */
+        clone_ctx = new ProgramContext(&this->memory_map);
+
+        status = clone_ctx->memory_map.clone_address_space(&this->memory_map);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("clone_address_space failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        /* The registers own their buffers, and so they are copied by value. */
+        clone_ctx->register_file.get_register_a()->write(this->register_file.get_register_a()->read());
+        clone_ctx->register_file.get_register_x()->write(this->register_file.get_register_x()->read());
+        clone_ctx->register_file.get_register_y()->write(this->register_file.get_register_y()->read());
+        clone_ctx->register_file.get_register_status()->write(this->register_file.get_register_status()->read());
+        clone_ctx->register_file.get_register_stack_pointer()->write(
+            this->register_file.get_register_stack_pointer()->read()
+        );
+        clone_ctx->register_file.get_register_program_counter()->write(
+            this->register_file.get_register_program_counter()->read()
+        );
+
+        clone_ctx->event_scheduler = this->event_scheduler;
+        clone_ctx->is_irq_masked = this->is_irq_masked;
+        clone_ctx->num_cycles = this->num_cycles;
+        clone_ctx->did_cross_page = this->did_cross_page;
+        clone_ctx->num_branch_cycles = this->num_branch_cycles;
+
+        *output_clone = clone_ctx;
+        clone_ctx = nullptr;
+
+        status = PENES_STATUS_SUCCESS;
+    l_cleanup:
+        delete clone_ctx;
+
+        return status;
+    }
+
+    /** @brief Schedule the IRQ held while the Interrupt Disable flag was set, once the flag has been cleared.
+     *         Every instruction that updates the Status register calls this, see CPU::dispatch_events.
+     * */
+    inline void release_masked_irq()
+    {
+        if ((false == this->is_irq_masked) ||
+            (0 != (this->register_file.get_register_status()->read() & REGISTER_STATUS_FLAG_MASK_INTERRUPT))) {
+            return;
+        }
+
+        this->is_irq_masked = false;
+        this->event_scheduler.schedule(EVENT_SCHEDULER_EVENT_TYPE_IRQ, this->num_cycles);
+    }
+
     RegisterFile register_file;
     MemoryMap memory_map;
-    bool did_receive_irq = false;
-    bool did_receive_nmi = false;
+    /* Interrupt sources, such as the PPU for NMI or a mapper's counter for IRQ, schedule their next interrupt here. */
+    EventScheduler event_scheduler;
+    /* Whether an IRQ became due while the Interrupt Disable flag was set, and is held until the flag is cleared.
+     * A source whose line is deasserted in the meantime should clear it.
+     * */
+    bool is_irq_masked = false;
+
+    /* The number of CPU cycles elapsed since power on. */
+    std::uint64_t num_cycles = 0;
+    /* Timing side effects of the instruction being executed, which the CPU adds to its base cycle count.
+     * Indexed address modes report whether the effective address crossed a page,
+     * and taken branches add their own penalty cycles.
+     * */
+    bool did_cross_page = false;
+    std::size_t num_branch_cycles = 0;
 };
 
 #endif /* __PROGRAM_CONTEXT_H__ */
@@ -0,0 +1,605 @@
+/**
+ * @brief  Persistent index of a ROM library, holding the parsed header and content hashes of each ROM.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <fstream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "utils/checksum.h"
+
+#include "gzip_reader/gzip_reader.h"
+#include "rom_index/rom_index.h"
+
+/** Constants *************************************************************/
+#define ROM_INDEX_BYTE_SIZE_BITS (8)
+#define ROM_INDEX_BYTE_MASK (0xFF)
+#define ROM_INDEX_DECOMPRESS_CHUNK_SIZE (0x100000)
+
+/** Functions *************************************************************/
+/** @brief Write an integer to a stream in little endian order, regardless of the host endianness. */
+template <typename IntegerType>
+static void write_integer(std::ofstream& output_stream, IntegerType value)
+{
+    std::size_t byte_index = 0;
+
+    for (byte_index = 0; byte_index < sizeof(IntegerType); byte_index++) {
+        output_stream.put(static_cast<char>(
+            (static_cast<std::uint64_t>(value) >> (byte_index * ROM_INDEX_BYTE_SIZE_BITS)) & ROM_INDEX_BYTE_MASK
+        ));
+    }
+}
+
+
+/** @brief Read a little endian integer from a stream. The stream's fail bit is set on failure. */
+template <typename IntegerType>
+static IntegerType read_integer(std::ifstream& input_stream)
+{
+    std::uint64_t value = 0;
+    std::size_t byte_index = 0;
+
+    for (byte_index = 0; byte_index < sizeof(IntegerType); byte_index++) {
+        value |= static_cast<std::uint64_t>(input_stream.get() & ROM_INDEX_BYTE_MASK) << (byte_index * ROM_INDEX_BYTE_SIZE_BITS);
+    }
+
+    return static_cast<IntegerType>(value);
+}
+
+
+/** @brief Whether a file name has an extension, ignoring case. The extension must be lower case. */
+static bool has_file_extension(const std::string& file_name, const std::string& extension)
+{
+    if (file_name.size() < extension.size()) {
+        return false;
+    }
+
+    return std::equal(
+        extension.begin(),
+        extension.end(),
+        file_name.end() - extension.size(),
+        [](char extension_char, char file_name_char) {
+            return extension_char == std::tolower(static_cast<unsigned char>(file_name_char));
+        }
+    );
+}
+
+
+/** @brief Whether a file name has the ROM file extension or the compressed ROM file extension. */
+static bool is_rom_file_name(const std::string& file_name)
+{
+    return (true == has_file_extension(file_name, ROM_INDEX_ROM_FILE_EXTENSION)) ||
+           (true == has_file_extension(file_name, ROM_INDEX_COMPRESSED_ROM_FILE_EXTENSION));
+}
+
+
+/** @brief Decompress a whole gzip compressed ROM file, verifying it against its trailer. */
+static enum PeNESStatus read_compressed_rom_file(const std::string& rom_file, std::vector<std::uint8_t> *output_image)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    GzipReader gzip_reader;
+    std::size_t image_size = 0;
+    std::size_t chunk_start = 0;
+    std::size_t chunk_size = 0;
+    std::size_t num_read = 0;
+
+    ASSERT(nullptr != output_image);
+
+    status = GzipReader::get_decompressed_size(rom_file, &image_size);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("get_decompressed_size failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = gzip_reader.open(rom_file);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The image grows by chunks as they are decompressed, so that the memory used is backed by actual data,
+     * rather than allocated up front by a size that is not verified yet.
+     * */
+    output_image->clear();
+    while (output_image->size() < image_size) {
+        chunk_start = output_image->size();
+        chunk_size = MIN(static_cast<std::size_t>(ROM_INDEX_DECOMPRESS_CHUNK_SIZE), image_size - chunk_start);
+        output_image->resize(chunk_start + chunk_size);
+
+        status = gzip_reader.read(&output_image->data()[chunk_start], chunk_size, &num_read);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("gzip_reader.read failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        output_image->resize(chunk_start + num_read);
+        if (num_read < chunk_size) {
+            break;
+        }
+    }
+
+    /* The size in the trailer is only a hint until the data has been verified against it. */
+    status = gzip_reader.finish();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.finish failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::add_file(const std::string& rom_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct ROMIndexEntry entry = {};
+    int rom_file_descriptor = -1;
+    struct stat rom_file_stat = {0};
+    void *rom_file_mapping = MAP_FAILED;
+    std::vector<std::uint8_t> decompressed_image;
+    const std::uint8_t *rom_file_buffer = nullptr;
+    std::size_t rom_image_size = 0;
+    std::size_t prg_rom_start = 0;
+    std::size_t chr_rom_start = 0;
+
+    rom_file_descriptor = open(rom_file.c_str(), O_RDONLY);
+    if (-1 == rom_file_descriptor) {
+        status = PENES_STATUS_ROM_INDEX_ADD_FILE_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (-1 == fstat(rom_file_descriptor, &rom_file_stat)) {
+        status = PENES_STATUS_ROM_INDEX_ADD_FILE_FSTAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("fstat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The hashes are of the decompressed image, so that a compressed ROM is found by the same hash as the original. */
+    if (true == GzipReader::is_gzip_file(rom_file)) {
+        status = read_compressed_rom_file(rom_file, &decompressed_image);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("read_compressed_rom_file failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        rom_file_buffer = decompressed_image.data();
+        rom_image_size = decompressed_image.size();
+    } else {
+        rom_image_size = rom_file_stat.st_size;
+    }
+
+    if (ROM_LOADER_NES_FILE_HEADER_SIZE > rom_image_size) {
+        status = PENES_STATUS_ROM_INDEX_ADD_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The file is smaller than a header. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* The whole file is hashed, and so it is mapped rather than read. */
+    if (nullptr == rom_file_buffer) {
+        rom_file_mapping = mmap(nullptr, rom_image_size, PROT_READ, MAP_PRIVATE, rom_file_descriptor, 0);
+        if (MAP_FAILED == rom_file_mapping) {
+            status = PENES_STATUS_ROM_INDEX_ADD_FILE_MMAP_FAILED;
+            DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("mmap failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        rom_file_buffer = static_cast<const std::uint8_t *>(rom_file_mapping);
+    }
+
+    status = ROMLoader::parse_header(rom_file_buffer, &entry.header);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("parse_header failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    prg_rom_start = ROMLoader::get_prg_rom_start(entry.header);
+    chr_rom_start = prg_rom_start + entry.header.prg_rom_size;
+    if (rom_image_size < chr_rom_start + entry.header.chr_rom_size) {
+        status = PENES_STATUS_ROM_INDEX_ADD_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The file is smaller than its ROM banks. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    entry.path = rom_file;
+    entry.file_size = rom_file_stat.st_size;
+    entry.modification_time = rom_file_stat.st_mtime;
+    entry.prg_rom_crc32 = utils::calculate_crc32(rom_file_buffer + prg_rom_start, entry.header.prg_rom_size);
+    entry.chr_rom_crc32 = utils::calculate_crc32(rom_file_buffer + chr_rom_start, entry.header.chr_rom_size);
+    entry.prg_rom_hash = utils::calculate_fnv1a_64(rom_file_buffer + prg_rom_start, entry.header.prg_rom_size);
+    entry.chr_rom_hash = utils::calculate_fnv1a_64(rom_file_buffer + chr_rom_start, entry.header.chr_rom_size);
+
+    this->insert_entry(entry);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (MAP_FAILED != rom_file_mapping) {
+        munmap(rom_file_mapping, rom_file_stat.st_size);
+    }
+
+    if (-1 != rom_file_descriptor) {
+        close(rom_file_descriptor);
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::find_rom_files(const std::string& directory, std::vector<std::string> *output_rom_files)
+{
+    std::set<std::pair<dev_t, ino_t>> visited_directories;
+
+    ASSERT(nullptr != output_rom_files);
+
+    return ROMIndex::find_rom_files_in_tree(directory, &visited_directories, output_rom_files);
+}
+
+
+enum PeNESStatus ROMIndex::find_rom_files_in_tree(
+    const std::string& directory,
+    std::set<std::pair<dev_t, ino_t>> *visited_directories,
+    std::vector<std::string> *output_rom_files
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    DIR *directory_stream = nullptr;
+    struct dirent *directory_entry = nullptr;
+    struct stat entry_stat = {0};
+    std::string entry_path;
+    std::string entry_name;
+
+    ASSERT(nullptr != visited_directories);
+    ASSERT(nullptr != output_rom_files);
+
+    directory_stream = opendir(directory.c_str());
+    if (nullptr == directory_stream) {
+        status = PENES_STATUS_ROM_INDEX_FIND_ROM_FILES_OPENDIR_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("opendir failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Symbolic links are followed, and so a link to an ancestor would otherwise be descended into forever. */
+    if (-1 == fstat(dirfd(directory_stream), &entry_stat)) {
+        status = PENES_STATUS_ROM_INDEX_FIND_ROM_FILES_FSTAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("fstat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (false == visited_directories->insert({entry_stat.st_dev, entry_stat.st_ino}).second) {
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    while (nullptr != (directory_entry = readdir(directory_stream))) {
+        entry_name = directory_entry->d_name;
+        if (("." == entry_name) || (".." == entry_name)) {
+            continue;
+        }
+
+        entry_path = directory + DIRPATH_SEPARATOR + entry_name;
+        if (-1 == stat(entry_path.c_str(), &entry_stat)) {
+            continue;
+        }
+
+        /* Descend into subdirectories, skipping the ones that cannot be read. */
+        if (S_ISDIR(entry_stat.st_mode)) {
+            ROMIndex::find_rom_files_in_tree(entry_path, visited_directories, output_rom_files);
+            continue;
+        }
+
+        if ((true == S_ISREG(entry_stat.st_mode)) && (true == is_rom_file_name(entry_name))) {
+            output_rom_files->push_back(entry_path);
+        }
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (nullptr != directory_stream) {
+        closedir(directory_stream);
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::scan_directory(
+    const std::string& directory,
+    std::size_t *output_num_added,
+    std::size_t *output_num_skipped
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::vector<std::string> rom_files;
+    std::size_t num_added = 0;
+    std::size_t num_skipped = 0;
+
+    status = ROMIndex::find_rom_files(directory, &rom_files);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("find_rom_files failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    for (const std::string& rom_file : rom_files) {
+        if (PENES_STATUS_SUCCESS == this->add_file(rom_file)) {
+            num_added++;
+        } else {
+            num_skipped++;
+        }
+    }
+
+    if (nullptr != output_num_added) {
+        *output_num_added = num_added;
+    }
+
+    if (nullptr != output_num_skipped) {
+        *output_num_skipped = num_skipped;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::save(const std::string& index_file) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ofstream output_stream;
+
+    output_stream.open(index_file, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_ROM_INDEX_SAVE_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the index file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    output_stream.write(ROM_INDEX_FILE_MAGIC, ROM_INDEX_FILE_MAGIC_SIZE);
+    write_integer<std::uint32_t>(output_stream, ROM_INDEX_FILE_VERSION);
+    write_integer<std::uint32_t>(output_stream, this->entries.size());
+
+    /* Every field is written explicitly, so that the file does not depend on the layout of the structs. */
+    for (const struct ROMIndexEntry& entry : this->entries) {
+        write_integer<std::uint16_t>(output_stream, entry.path.size());
+        output_stream.write(entry.path.data(), entry.path.size());
+
+        write_integer<std::uint64_t>(output_stream, entry.file_size);
+        write_integer<std::int64_t>(output_stream, entry.modification_time);
+
+        write_integer<std::uint8_t>(output_stream, entry.header.is_nes2);
+        write_integer<std::uint16_t>(output_stream, entry.header.mapper_number);
+        write_integer<std::uint8_t>(output_stream, entry.header.submapper_number);
+        write_integer<std::int8_t>(output_stream, entry.header.mirroring);
+        write_integer<std::uint8_t>(output_stream, entry.header.has_battery);
+        write_integer<std::uint8_t>(output_stream, entry.header.has_trainer);
+        write_integer<std::uint8_t>(output_stream, entry.header.console_type);
+        write_integer<std::uint8_t>(output_stream, entry.header.timing_mode);
+        write_integer<std::uint64_t>(output_stream, entry.header.prg_rom_size);
+        write_integer<std::uint64_t>(output_stream, entry.header.chr_rom_size);
+        write_integer<std::uint64_t>(output_stream, entry.header.prg_ram_size);
+        write_integer<std::uint64_t>(output_stream, entry.header.prg_nvram_size);
+        write_integer<std::uint64_t>(output_stream, entry.header.chr_ram_size);
+        write_integer<std::uint64_t>(output_stream, entry.header.chr_nvram_size);
+
+        write_integer<std::uint32_t>(output_stream, entry.prg_rom_crc32);
+        write_integer<std::uint32_t>(output_stream, entry.chr_rom_crc32);
+        write_integer<std::uint64_t>(output_stream, entry.prg_rom_hash);
+        write_integer<std::uint64_t>(output_stream, entry.chr_rom_hash);
+    }
+
+    output_stream.flush();
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_ROM_INDEX_SAVE_WRITE_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to write the index file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::load(const std::string& index_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ifstream input_stream;
+    char file_magic_buffer[ROM_INDEX_FILE_MAGIC_SIZE] = {0};
+    std::uint32_t num_entries = 0;
+    std::uint32_t entry_index = 0;
+    struct ROMIndexEntry entry = {};
+
+    this->entries.clear();
+    this->entry_indices.clear();
+    this->hash_entry_indices.clear();
+
+    input_stream.open(index_file, std::ifstream::in | std::ifstream::binary);
+    if (true == input_stream.fail()) {
+        status = PENES_STATUS_ROM_INDEX_LOAD_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the index file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    input_stream.read(file_magic_buffer, sizeof(file_magic_buffer));
+    if ((true == input_stream.fail()) ||
+        (CMP_EQUAL != memcmp(ROM_INDEX_FILE_MAGIC, file_magic_buffer, ROM_INDEX_FILE_MAGIC_SIZE))) {
+        status = PENES_STATUS_ROM_INDEX_LOAD_INVALID_FILE;
+        DEBUG_PRINT_WITH_ARGS("Invalid index file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (ROM_INDEX_FILE_VERSION != read_integer<std::uint32_t>(input_stream)) {
+        status = PENES_STATUS_ROM_INDEX_LOAD_UNSUPPORTED_VERSION;
+        DEBUG_PRINT_WITH_ARGS("Unsupported index file version. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    num_entries = read_integer<std::uint32_t>(input_stream);
+
+    for (entry_index = 0; entry_index < num_entries; entry_index++) {
+        entry.path.resize(read_integer<std::uint16_t>(input_stream));
+        input_stream.read(&entry.path[0], entry.path.size());
+
+        entry.file_size = read_integer<std::uint64_t>(input_stream);
+        entry.modification_time = read_integer<std::int64_t>(input_stream);
+
+        entry.header.is_nes2 = (0 != read_integer<std::uint8_t>(input_stream));
+        entry.header.mapper_number = read_integer<std::uint16_t>(input_stream);
+        entry.header.submapper_number = read_integer<std::uint8_t>(input_stream);
+        entry.header.mirroring = static_cast<enum ROMLoaderMirroring>(read_integer<std::int8_t>(input_stream));
+        entry.header.has_battery = (0 != read_integer<std::uint8_t>(input_stream));
+        entry.header.has_trainer = (0 != read_integer<std::uint8_t>(input_stream));
+        entry.header.console_type = read_integer<std::uint8_t>(input_stream);
+        entry.header.timing_mode = read_integer<std::uint8_t>(input_stream);
+        entry.header.prg_rom_size = read_integer<std::uint64_t>(input_stream);
+        entry.header.chr_rom_size = read_integer<std::uint64_t>(input_stream);
+        entry.header.prg_ram_size = read_integer<std::uint64_t>(input_stream);
+        entry.header.prg_nvram_size = read_integer<std::uint64_t>(input_stream);
+        entry.header.chr_ram_size = read_integer<std::uint64_t>(input_stream);
+        entry.header.chr_nvram_size = read_integer<std::uint64_t>(input_stream);
+
+        entry.prg_rom_crc32 = read_integer<std::uint32_t>(input_stream);
+        entry.chr_rom_crc32 = read_integer<std::uint32_t>(input_stream);
+        entry.prg_rom_hash = read_integer<std::uint64_t>(input_stream);
+        entry.chr_rom_hash = read_integer<std::uint64_t>(input_stream);
+
+        if (true == input_stream.fail()) {
+            status = PENES_STATUS_ROM_INDEX_LOAD_READ_FAILED;
+            DEBUG_PRINT_WITH_ARGS("Failed to read index entry. Status: %d. Entry: %u\n", status, entry_index);
+            goto l_cleanup;
+        }
+
+        this->insert_entry(entry);
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::find_entry(const std::string& rom_file, const struct ROMIndexEntry **output_entry) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::unordered_map<std::string, std::size_t>::const_iterator entry_index_iter;
+    const struct ROMIndexEntry *entry = nullptr;
+    struct stat rom_file_stat = {0};
+
+    ASSERT(nullptr != output_entry);
+
+    entry_index_iter = this->entry_indices.find(rom_file);
+    if (this->entry_indices.end() == entry_index_iter) {
+        status = PENES_STATUS_ROM_INDEX_FIND_ENTRY_NOT_FOUND;
+        DEBUG_PRINT_WITH_ARGS("The file is not indexed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    entry = &this->entries[entry_index_iter->second];
+
+    /* The entry can only be trusted in place of the file's header if the file has not changed since. */
+    if (-1 == stat(rom_file.c_str(), &rom_file_stat)) {
+        status = PENES_STATUS_ROM_INDEX_FIND_ENTRY_STAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("stat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if ((entry->file_size != static_cast<std::uint64_t>(rom_file_stat.st_size)) ||
+        (entry->modification_time != static_cast<std::int64_t>(rom_file_stat.st_mtime))) {
+        status = PENES_STATUS_ROM_INDEX_FIND_ENTRY_STALE_ENTRY;
+        DEBUG_PRINT_WITH_ARGS("The file has changed since it was indexed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    *output_entry = entry;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMIndex::find_entry_by_hash(
+    std::uint64_t prg_rom_hash,
+    std::uint64_t chr_rom_hash,
+    const struct ROMIndexEntry **output_entry
+) const
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::pair<
+        std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator,
+        std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator
+    > hash_entry_range;
+    std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator hash_entry_iter;
+
+    ASSERT(nullptr != output_entry);
+
+    hash_entry_range = this->hash_entry_indices.equal_range(prg_rom_hash);
+    for (hash_entry_iter = hash_entry_range.first; hash_entry_range.second != hash_entry_iter; ++hash_entry_iter) {
+        if (chr_rom_hash == this->entries[hash_entry_iter->second].chr_rom_hash) {
+            *output_entry = &this->entries[hash_entry_iter->second];
+
+            status = PENES_STATUS_SUCCESS;
+            goto l_cleanup;
+        }
+    }
+
+    status = PENES_STATUS_ROM_INDEX_FIND_ENTRY_BY_HASH_NOT_FOUND;
+    DEBUG_PRINT_WITH_ARGS("No indexed ROM has the hashes. Status: %d.\n", status);
+
+l_cleanup:
+    return status;
+}
+
+
+void ROMIndex::insert_entry(const struct ROMIndexEntry& entry)
+{
+    std::unordered_map<std::string, std::size_t>::const_iterator entry_index_iter;
+    std::pair<
+        std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator,
+        std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator
+    > hash_entry_range;
+    std::unordered_multimap<std::uint64_t, std::size_t>::const_iterator hash_entry_iter;
+    std::size_t entry_index = 0;
+
+    entry_index_iter = this->entry_indices.find(entry.path);
+    if (this->entry_indices.end() != entry_index_iter) {
+        entry_index = entry_index_iter->second;
+
+        /* The contents of the file may have changed, and so the entry is rehashed under its new hash. */
+        hash_entry_range = this->hash_entry_indices.equal_range(this->entries[entry_index].prg_rom_hash);
+        for (hash_entry_iter = hash_entry_range.first; hash_entry_range.second != hash_entry_iter; ++hash_entry_iter) {
+            if (entry_index == hash_entry_iter->second) {
+                break;
+            }
+        }
+
+        /* Every entry is indexed under its hash, and so it is always found. */
+        ASSERT(hash_entry_range.second != hash_entry_iter);
+
+        this->hash_entry_indices.erase(hash_entry_iter);
+        this->entries[entry_index] = entry;
+    } else {
+        entry_index = this->entries.size();
+        this->entry_indices[entry.path] = entry_index;
+        this->entries.push_back(entry);
+    }
+
+    this->hash_entry_indices.emplace(entry.prg_rom_hash, entry_index);
+}
@@ -0,0 +1,141 @@
+/**
+ * @brief  Persistent index of a ROM library, holding the parsed header and content hashes of each ROM.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __ROM_INDEX_H__
+#define __ROM_INDEX_H__
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/types.h>
+
+#include "penes_status.h"
+
+#include "rom_loader/rom_loader.h"
+
+/** Constants *************************************************************/
+#define ROM_INDEX_FILE_MAGIC ("PNIX")
+#define ROM_INDEX_FILE_MAGIC_SIZE (4)
+#define ROM_INDEX_FILE_VERSION (1)
+#define ROM_INDEX_ROM_FILE_EXTENSION (".nes")
+#define ROM_INDEX_COMPRESSED_ROM_FILE_EXTENSION (".nes.gz")
+
+/** Structs ***************************************************************/
+/** @brief A single indexed ROM. */
+struct ROMIndexEntry {
+    std::string path;
+    /* The hashes and the header are of the decompressed image, whether or not the file is gzip compressed. */
+    /* The size and modification time of the file when it was indexed, used to detect stale entries. */
+    std::uint64_t file_size;
+    std::int64_t modification_time;
+    struct ROMLoaderHeader header;
+    std::uint32_t prg_rom_crc32;
+    std::uint32_t chr_rom_crc32;
+    std::uint64_t prg_rom_hash;
+    std::uint64_t chr_rom_hash;
+};
+
+/** Classes ***************************************************************/
+class ROMIndex {
+public:
+    /** @brief          Index a single ROM file, replacing its previous entry if there is one.
+     *                  A gzip compressed file is decompressed and indexed by its contents.
+     *
+     *  @param[in]      rom_file                    The path of the ROM file, stored in the index as is.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus add_file(const std::string& rom_file);
+
+    /** @brief          Index every ROM file in a directory tree.
+     *                  Files that are not valid ROMs are skipped rather than failing the scan.
+     *
+     *  @param[in]      directory                   The root of the directory tree.
+     *  @param[out]     output_num_added            The number of indexed ROM files, may be nullptr.
+     *  @param[out]     output_num_skipped          The number of skipped ROM files, may be nullptr.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus scan_directory(
+        const std::string& directory,
+        std::size_t *output_num_added = nullptr,
+        std::size_t *output_num_skipped = nullptr
+    );
+
+    /** @brief          Find every ROM file in a directory tree, by its file extension.
+     *                  Subdirectories that cannot be read are skipped.
+     *                  Symbolic links are followed, but every directory is searched once, even if linked in a loop.
+     *
+     *  @param[in]      directory                   The root of the directory tree.
+     *  @param[out]     output_rom_files            The vector to append the paths of the ROM files to.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus find_rom_files(const std::string& directory, std::vector<std::string> *output_rom_files);
+
+    enum PeNESStatus save(const std::string& index_file) const;
+
+    /** @brief          Load an index file, replacing all current entries. */
+    enum PeNESStatus load(const std::string& index_file);
+
+    /** @brief          Find the entry of a ROM file, verifying that the file has not changed since it was indexed.
+     *
+     *  @param[in]      rom_file                    The path of the ROM file, as it was indexed.
+     *  @param[out]     output_entry                The entry of the file.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus find_entry(const std::string& rom_file, const struct ROMIndexEntry **output_entry) const;
+
+    /** @brief          Find an entry by the contents of its ROM, such as to recognize a renamed or recompressed file.
+     *
+     *  @param[in]      prg_rom_hash                The 64-bit FNV-1a hash of the PRG-ROM.
+     *  @param[in]      chr_rom_hash                The 64-bit FNV-1a hash of the CHR-ROM.
+     *  @param[out]     output_entry                The first indexed entry with both hashes.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus find_entry_by_hash(
+        std::uint64_t prg_rom_hash,
+        std::uint64_t chr_rom_hash,
+        const struct ROMIndexEntry **output_entry
+    ) const;
+
+    inline const std::vector<struct ROMIndexEntry>& get_entries() const
+    {
+        return this->entries;
+    }
+
+private:
+    void insert_entry(const struct ROMIndexEntry& entry);
+
+    /** @brief          Find every ROM file in a directory tree, skipping the directories already searched.
+     *
+     *  @param[in]      directory                   The root of the directory tree.
+     *  @param[in,out]  visited_directories         The device and inode of each directory searched so far.
+     *  @param[out]     output_rom_files            The vector to append the paths of the ROM files to.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus find_rom_files_in_tree(
+        const std::string& directory,
+        std::set<std::pair<dev_t, ino_t>> *visited_directories,
+        std::vector<std::string> *output_rom_files
+    );
+
+    std::vector<struct ROMIndexEntry> entries;
+    std::unordered_map<std::string, std::size_t> entry_indices;
+    std::unordered_multimap<std::uint64_t, std::size_t> hash_entry_indices;
+};
+
+
+#endif /* __ROM_INDEX_H__ */
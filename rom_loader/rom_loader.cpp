@@ -9,31 +9,156 @@
 #include <iostream>
 #include <fstream>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include "penes_status.h"
 #include "common.h"
 
+#include "gzip_reader/gzip_reader.h"
 #include "rom_loader/rom_loader.h"
 
 /** Constants *************************************************************/
 #define ROM_LOADER_NES_FILE_MAGIC ("NES\x1A")
 #define ROM_LOADER_NES_FILE_MAGIC_SIZE (4)
-#define ROM_LOADER_NES_FILE_ROM_SIZE_MSB_OFFSET (9)
-#define ROM_LOADER_NES_FILE_PRG_ROM_OFFSET (16)
+
+#define ROM_LOADER_HEADER_PRG_ROM_SIZE_LSB_OFFSET (4)
+#define ROM_LOADER_HEADER_CHR_ROM_SIZE_LSB_OFFSET (5)
+#define ROM_LOADER_HEADER_FLAGS_6_OFFSET (6)
+#define ROM_LOADER_HEADER_FLAGS_7_OFFSET (7)
+#define ROM_LOADER_HEADER_MAPPER_OFFSET (8)
+#define ROM_LOADER_HEADER_PRG_RAM_SIZE_OFFSET (8)
+#define ROM_LOADER_HEADER_ROM_SIZE_MSB_OFFSET (9)
+#define ROM_LOADER_HEADER_PRG_RAM_SHIFT_OFFSET (10)
+#define ROM_LOADER_HEADER_CHR_RAM_SHIFT_OFFSET (11)
+#define ROM_LOADER_HEADER_TIMING_OFFSET (12)
+#define ROM_LOADER_HEADER_PADDING_OFFSET (12)
+
+#define ROM_LOADER_FLAGS_6_VERTICAL_MIRRORING_MASK (1 << 0)
+#define ROM_LOADER_FLAGS_6_BATTERY_MASK (1 << 1)
+#define ROM_LOADER_FLAGS_6_TRAINER_MASK (1 << 2)
+#define ROM_LOADER_FLAGS_6_FOUR_SCREEN_MASK (1 << 3)
+#define ROM_LOADER_FLAGS_7_CONSOLE_TYPE_MASK (0b11)
+#define ROM_LOADER_FLAGS_7_NES2_MASK (0b1100)
+#define ROM_LOADER_FLAGS_7_NES2_VALUE (0b1000)
+#define ROM_LOADER_TIMING_MODE_MASK (0b11)
+
 #define ROM_LOADER_NIBBLE_BIT_MASK (0b1111)
 #define ROM_LOADER_NIBBLE_SIZE_BITS (4)
-#define ROM_LOADER_PRG_ROM_BANK_SIZE (0x4000)
+#define ROM_LOADER_BYTE_SIZE_BITS (8)
+
+/* NES 2.0 sizes whose MSB nibble is all set use the exponent-multiplier notation: 2^E * (2 * M + 1). */
+#define ROM_LOADER_NES2_EXPONENT_NOTATION_MSB (0b1111)
+#define ROM_LOADER_NES2_MULTIPLIER_MASK (0b11)
+#define ROM_LOADER_NES2_EXPONENT_SHIFT (2)
+#define ROM_LOADER_NES2_MAX_EXPONENT (32)
+#define ROM_LOADER_NES2_RAM_SIZE_BASE (64)
+
+#define ROM_LOADER_INES_PRG_RAM_UNIT_SIZE (0x2000)
+#define ROM_LOADER_INES_CHR_RAM_SIZE (0x2000)
 
 /** Functions *************************************************************/
-enum PeNESStatus ROMLoader::open(const std::string& input_file)
+/** @brief Calculate a NES 2.0 ROM size from its LSB and MSB nibble, returning 0 for sizes that do not fit. */
+static std::size_t calculate_nes2_rom_size(std::uint8_t size_lsb, std::uint8_t size_msb_nibble, std::size_t bank_size)
+{
+    std::size_t exponent = 0;
+    std::size_t multiplier = 0;
+
+    if (ROM_LOADER_NES2_EXPONENT_NOTATION_MSB != size_msb_nibble) {
+        return ((static_cast<std::size_t>(size_msb_nibble) << ROM_LOADER_BYTE_SIZE_BITS) | size_lsb) * bank_size;
+    }
+
+    exponent = size_lsb >> ROM_LOADER_NES2_EXPONENT_SHIFT;
+    multiplier = (size_lsb & ROM_LOADER_NES2_MULTIPLIER_MASK) * 2 + 1;
+    if (ROM_LOADER_NES2_MAX_EXPONENT <= exponent) {
+        return 0;
+    }
+
+    return (static_cast<std::size_t>(1) << exponent) * multiplier;
+}
+
+
+/** @brief          Decode the two bitplanes of a CHR tile into a palette index per pixel.
+ *
+ *  @param[in]      tile_planes                 ROM_LOADER_CHR_TILE_SIZE bytes: the low bitplane rows,
+ *                                              followed by the high bitplane rows.
+ *  @param[out]     decoded_tile                ROM_LOADER_DECODED_CHR_TILE_SIZE palette indices.
+ * */
+static void decode_chr_tile(const native_word_t *tile_planes, native_word_t *decoded_tile)
+{
+    std::size_t row = 0;
+    std::size_t column = 0;
+    native_word_t low_plane = 0;
+    native_word_t high_plane = 0;
+    std::size_t pixel_shift = 0;
+
+    for (row = 0; row < ROM_LOADER_CHR_TILE_HEIGHT; row++) {
+        low_plane = tile_planes[row];
+        high_plane = tile_planes[row + ROM_LOADER_CHR_TILE_HEIGHT];
+
+        /* The most significant bit of each plane row is the leftmost pixel. */
+        for (column = 0; column < ROM_LOADER_CHR_TILE_WIDTH; column++) {
+            pixel_shift = ROM_LOADER_CHR_TILE_WIDTH - 1 - column;
+            decoded_tile[(row * ROM_LOADER_CHR_TILE_WIDTH) + column] =
+                ((low_plane >> pixel_shift) & 1) | (((high_plane >> pixel_shift) & 1) << 1);
+        }
+    }
+}
+
+
+/** @brief Calculate a NES 2.0 RAM size from its shift count, where a shift count of 0 means there is no RAM. */
+static std::size_t calculate_nes2_ram_size(std::uint8_t shift_count)
+{
+    if (0 == shift_count) {
+        return 0;
+    }
+
+    return static_cast<std::size_t>(ROM_LOADER_NES2_RAM_SIZE_BASE) << shift_count;
+}
+
+
+enum PeNESStatus ROMLoader::open(const std::string& input_file, bool is_memory_mapped)
+{
+    return this->open_file(input_file, nullptr, is_memory_mapped);
+}
+
+
+enum PeNESStatus ROMLoader::open_with_header(
+    const std::string& input_file,
+    const struct ROMLoaderHeader& known_header,
+    bool is_memory_mapped
+)
+{
+    return this->open_file(input_file, &known_header, is_memory_mapped);
+}
+
+
+enum PeNESStatus ROMLoader::open_file(
+    const std::string& input_file,
+    const struct ROMLoaderHeader *known_header,
+    bool is_memory_mapped
+)
 {
     enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-    char file_magic_buffer[ROM_LOADER_NES_FILE_MAGIC_SIZE] = {0};
-    std::size_t temp_prg_rom_banks = 0;
-    std::size_t temp_chr_rom_banks = 0;
-    std::uint8_t combined_rom_size_msb = 0;
+    std::uint8_t header_buffer[ROM_LOADER_NES_FILE_HEADER_SIZE] = {0};
+    struct ROMLoaderHeader parsed_header = {};
+    std::streamoff file_size = 0;
 
     /* Close the previous input file in case it was open. */
     this->input_file_stream.close();
+    this->close_image();
+
+    /* Compressed images have no file offsets to read banks from, and so they are decompressed into memory. */
+    if (true == GzipReader::is_gzip_file(input_file)) {
+        status = this->open_gzip_file(input_file, known_header);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("open_gzip_file failed. Status: %d.\n", status);
+        }
+
+        goto l_cleanup;
+    }
 
     /* Open the source file and check if the operation has succeeded. */
     this->input_file_stream.open(input_file, std::ifstream::in | std::ifstream::binary);
@@ -43,58 +168,375 @@ enum PeNESStatus ROMLoader::open(const std::string& input_file)
         goto l_cleanup;
     }
 
-    /* Read the magic of the file to verify that it is of type iNES. */
-    this->input_file_stream.read(file_magic_buffer, sizeof(file_magic_buffer));
-    if (true == this->input_file_stream.fail()) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_READ_MAGIC_FAILED;
-        DEBUG_PRINT_WITH_ARGS("Failed to read file magic. Status: %d.\n", status);
+    /* Retrieve the size of the file, so that the banks specified by the header can be verified to exist. */
+    this->input_file_stream.seekg(0, std::ifstream::end);
+    file_size = this->input_file_stream.tellg();
+    this->input_file_stream.seekg(0, std::ifstream::beg);
+    if ((true == this->input_file_stream.fail()) || (0 > file_size)) {
+        status = PENES_STATUS_ROM_LOADER_OPEN_GET_FILE_SIZE_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to retrieve the file size. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    if (CMP_EQUAL != strcmp(ROM_LOADER_NES_FILE_MAGIC, file_magic_buffer)) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_INVALID_FILE;
-        DEBUG_PRINT_WITH_ARGS("Invalid input file. Status: %d.\n", status);
+    /* Read the whole header at once and parse it, unless it has already been parsed before. */
+    if (nullptr == known_header) {
+        this->input_file_stream.read(reinterpret_cast<char *>(header_buffer), sizeof(header_buffer));
+        if (true == this->input_file_stream.fail()) {
+            status = PENES_STATUS_ROM_LOADER_OPEN_READ_HEADER_FAILED;
+            DEBUG_PRINT_WITH_ARGS("Failed to read the file header. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        status = ROMLoader::parse_header(header_buffer, &parsed_header);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("parse_header failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        known_header = &parsed_header;
+    }
+
+    status = this->setup_banks(*known_header, static_cast<std::size_t>(file_size));
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("setup_banks failed. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    /* Read the LSB of the PRG-ROM and CHR-ROM bank counts, respectively. */
-    temp_prg_rom_banks = this->input_file_stream.get();
-    if (true == this->input_file_stream.fail()) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_GET_PRG_ROM_BANKS_LSB_FAILED;
-        DEBUG_PRINT_WITH_ARGS("Failed to read PRG-ROM bank count LSB. Status: %d.\n", status);
+    /* In memory mapped mode, banks are handed out straight from the mapping instead of being read from the stream. */
+    if (true == is_memory_mapped) {
+        status = this->map_file(input_file);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("map_file failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->input_file_stream.close();
+    }
+
+    /* The CHR-ROM is small, and so it is loaded and decoded up front. */
+    status = this->load_chr_rom();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("load_chr_rom failed. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    temp_chr_rom_banks = this->input_file_stream.get();
-    if (true == this->input_file_stream.fail()) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_GET_CHR_ROM_BANKS_LSB_FAILED;
-        DEBUG_PRINT_WITH_ARGS("Failed to read CHR-ROM bank count LSB. Status: %d.\n", status);
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (PENES_STATUS_SUCCESS != status) {
+        this->input_file_stream.close();
+        this->close_image();
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::open_gzip_file(const std::string& input_file, const struct ROMLoaderHeader *known_header)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    GzipReader gzip_reader;
+    std::uint8_t header_buffer[ROM_LOADER_NES_FILE_HEADER_SIZE] = {0};
+    struct ROMLoaderHeader parsed_header = {};
+    std::size_t decompressed_size = 0;
+    std::size_t num_read = 0;
+
+    status = GzipReader::get_decompressed_size(input_file, &decompressed_size);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("get_decompressed_size failed. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    /* Seek to the location specifying the combined MSB of the PRG-ROM and the CHR-ROM bank count. */
-    this->input_file_stream.seekg(ROM_LOADER_NES_FILE_ROM_SIZE_MSB_OFFSET);
-    if (true == input_file_stream.fail()) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_SEEK_BANK_COUNT_FAILED;
-        DEBUG_PRINT_WITH_ARGS("seekg to the MSB failed. Status: %d.\n", status);
+    status = gzip_reader.open(input_file);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.open failed. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    /* Read the combined MSB and parse it into the PRG/CHR nibbles. */
-    combined_rom_size_msb = this->input_file_stream.get();
-    if (true == this->input_file_stream.fail()) {
-        status = PENES_STATUS_ROM_LOADER_OPEN_READ_ROM_BANK_MSB_FAILED;
-        DEBUG_PRINT_WITH_ARGS("Failed to read the PRG/CHR bank count MSB. Status: %d.\n", status);
+    /* The header is decompressed first, so that the size of the image is known before the rest is. */
+    status = gzip_reader.read(header_buffer, sizeof(header_buffer), &num_read);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.read failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (sizeof(header_buffer) > num_read) {
+        status = PENES_STATUS_ROM_LOADER_OPEN_GZIP_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The image is smaller than a header. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (nullptr == known_header) {
+        status = ROMLoader::parse_header(header_buffer, &parsed_header);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("parse_header failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        known_header = &parsed_header;
+    }
+
+    /* The rest of the image is decompressed straight into the buffer the banks are then used from in place.
+     * The header alone is not trusted with the size of the buffer, since sizes in exponent notation reach gigabytes,
+     * and so an image larger than the decompressed data is rejected before anything is allocated.
+     * */
+    this->image_buffer_size = ROMLoader::get_prg_rom_start(*known_header) +
+                              known_header->prg_rom_size + known_header->chr_rom_size;
+    if (decompressed_size < this->image_buffer_size) {
+        status = PENES_STATUS_ROM_LOADER_OPEN_GZIP_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The image is smaller than its ROM banks. Status: %d.\n", status);
         goto l_cleanup;
     }
 
-    /* TODO Ugh */
-    /* Add the respective nibbles to the size totals. */
-    temp_prg_rom_banks += (combined_rom_size_msb & (ROM_LOADER_NIBBLE_BIT_MASK << ROM_LOADER_NIBBLE_SIZE_BITS) << ROM_LOADER_NIBBLE_SIZE_BITS);
-    temp_chr_rom_banks += (combined_rom_size_msb & (ROM_LOADER_NIBBLE_SIZE_BITS) << (ROM_LOADER_NIBBLE_SIZE_BITS * 2));
+    this->image_buffer = new native_word_t[this->image_buffer_size];
+    this->image_source = ROM_LOADER_IMAGE_SOURCE_OWNED_BUFFER;
 
-    this->num_prg_rom_banks = temp_prg_rom_banks;
-    this->num_chr_rom_banks = temp_chr_rom_banks;
+    COPY_MEMORY(this->image_buffer, header_buffer, sizeof(header_buffer));
+
+    status = gzip_reader.read(
+        &this->image_buffer[sizeof(header_buffer)],
+        this->image_buffer_size - sizeof(header_buffer),
+        &num_read
+    );
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.read failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Any data past the banks is discarded, but is still verified along with the rest of the image. */
+    status = gzip_reader.finish();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("gzip_reader.finish failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->setup_banks(*known_header, sizeof(header_buffer) + num_read);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("setup_banks failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->load_chr_rom();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("load_chr_rom failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (PENES_STATUS_SUCCESS != status) {
+        this->close_image();
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::open_from_buffer(
+    const std::uint8_t *image_buffer,
+    std::size_t image_buffer_size,
+    bool is_owned
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct ROMLoaderHeader parsed_header = {};
+
+    ASSERT(nullptr != image_buffer);
+
+    /* Close the previous image in case it was open, and take the new one.
+     * An owned buffer is only ever written to through the banks used in place, which the loader owns as well.
+     * */
+    this->input_file_stream.close();
+    this->close_image();
+
+    this->image_source = (true == is_owned)? ROM_LOADER_IMAGE_SOURCE_OWNED_BUFFER: ROM_LOADER_IMAGE_SOURCE_BORROWED_BUFFER;
+    this->image_buffer = const_cast<native_word_t *>(image_buffer);
+    this->image_buffer_size = image_buffer_size;
+
+    if (ROM_LOADER_NES_FILE_HEADER_SIZE > image_buffer_size) {
+        status = PENES_STATUS_ROM_LOADER_OPEN_FROM_BUFFER_TRUNCATED_BUFFER;
+        DEBUG_PRINT_WITH_ARGS("The buffer is smaller than a header. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = ROMLoader::parse_header(image_buffer, &parsed_header);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("parse_header failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->setup_banks(parsed_header, image_buffer_size);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("setup_banks failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = this->load_chr_rom();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("load_chr_rom failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    if (PENES_STATUS_SUCCESS != status) {
+        this->close_image();
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::parse_header(const std::uint8_t *header_buffer, struct ROMLoaderHeader *output_header)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct ROMLoaderHeader parsed_header = {};
+    std::uint8_t flags_6 = 0;
+    std::uint8_t flags_7 = 0;
+    std::uint8_t rom_size_msb = 0;
+    std::size_t padding_index = 0;
+    bool is_padding_clean = true;
+
+    ASSERT(nullptr != header_buffer);
+    ASSERT(nullptr != output_header);
+
+    /* Verify the magic of the file, which is not null terminated. */
+    if (CMP_EQUAL != memcmp(ROM_LOADER_NES_FILE_MAGIC, header_buffer, ROM_LOADER_NES_FILE_MAGIC_SIZE)) {
+        status = PENES_STATUS_ROM_LOADER_PARSE_HEADER_INVALID_MAGIC;
+        DEBUG_PRINT_WITH_ARGS("Invalid input file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    flags_6 = header_buffer[ROM_LOADER_HEADER_FLAGS_6_OFFSET];
+    flags_7 = header_buffer[ROM_LOADER_HEADER_FLAGS_7_OFFSET];
+
+    /* Flags shared by both formats. */
+    parsed_header.is_nes2 = (ROM_LOADER_FLAGS_7_NES2_VALUE == (flags_7 & ROM_LOADER_FLAGS_7_NES2_MASK));
+    parsed_header.has_battery = (0 != (flags_6 & ROM_LOADER_FLAGS_6_BATTERY_MASK));
+    parsed_header.has_trainer = (0 != (flags_6 & ROM_LOADER_FLAGS_6_TRAINER_MASK));
+
+    if (0 != (flags_6 & ROM_LOADER_FLAGS_6_FOUR_SCREEN_MASK)) {
+        parsed_header.mirroring = ROM_LOADER_MIRRORING_FOUR_SCREEN;
+    } else if (0 != (flags_6 & ROM_LOADER_FLAGS_6_VERTICAL_MIRRORING_MASK)) {
+        parsed_header.mirroring = ROM_LOADER_MIRRORING_VERTICAL;
+    } else {
+        parsed_header.mirroring = ROM_LOADER_MIRRORING_HORIZONTAL;
+    }
+
+    /* The low nibble of the mapper number is the high nibble of flags 6. */
+    parsed_header.mapper_number = flags_6 >> ROM_LOADER_NIBBLE_SIZE_BITS;
+
+    if (true == parsed_header.is_nes2) {
+        /* The size MSBs are combined from the low nibble for PRG-ROM and the high nibble for CHR-ROM. */
+        rom_size_msb = header_buffer[ROM_LOADER_HEADER_ROM_SIZE_MSB_OFFSET];
+
+        parsed_header.prg_rom_size = calculate_nes2_rom_size(
+            header_buffer[ROM_LOADER_HEADER_PRG_ROM_SIZE_LSB_OFFSET],
+            rom_size_msb & ROM_LOADER_NIBBLE_BIT_MASK,
+            ROM_LOADER_PRG_ROM_BANK_SIZE
+        );
+        parsed_header.chr_rom_size = calculate_nes2_rom_size(
+            header_buffer[ROM_LOADER_HEADER_CHR_ROM_SIZE_LSB_OFFSET],
+            rom_size_msb >> ROM_LOADER_NIBBLE_SIZE_BITS,
+            ROM_LOADER_CHR_ROM_BANK_SIZE
+        );
+
+        parsed_header.mapper_number |= (flags_7 >> ROM_LOADER_NIBBLE_SIZE_BITS) << ROM_LOADER_NIBBLE_SIZE_BITS;
+        parsed_header.mapper_number |= (header_buffer[ROM_LOADER_HEADER_MAPPER_OFFSET] & ROM_LOADER_NIBBLE_BIT_MASK)
+                                       << ROM_LOADER_BYTE_SIZE_BITS;
+        parsed_header.submapper_number = header_buffer[ROM_LOADER_HEADER_MAPPER_OFFSET] >> ROM_LOADER_NIBBLE_SIZE_BITS;
+        parsed_header.console_type = flags_7 & ROM_LOADER_FLAGS_7_CONSOLE_TYPE_MASK;
+        parsed_header.timing_mode = header_buffer[ROM_LOADER_HEADER_TIMING_OFFSET] & ROM_LOADER_TIMING_MODE_MASK;
+
+        /* RAM sizes are shift counts, with the volatile size in the low nibble and the non-volatile size in the high. */
+        parsed_header.prg_ram_size = calculate_nes2_ram_size(
+            header_buffer[ROM_LOADER_HEADER_PRG_RAM_SHIFT_OFFSET] & ROM_LOADER_NIBBLE_BIT_MASK
+        );
+        parsed_header.prg_nvram_size = calculate_nes2_ram_size(
+            header_buffer[ROM_LOADER_HEADER_PRG_RAM_SHIFT_OFFSET] >> ROM_LOADER_NIBBLE_SIZE_BITS
+        );
+        parsed_header.chr_ram_size = calculate_nes2_ram_size(
+            header_buffer[ROM_LOADER_HEADER_CHR_RAM_SHIFT_OFFSET] & ROM_LOADER_NIBBLE_BIT_MASK
+        );
+        parsed_header.chr_nvram_size = calculate_nes2_ram_size(
+            header_buffer[ROM_LOADER_HEADER_CHR_RAM_SHIFT_OFFSET] >> ROM_LOADER_NIBBLE_SIZE_BITS
+        );
+
+        /* A zero size in exponent notation cannot be told apart from a size that does not fit, and both are invalid. */
+        if (((0 == parsed_header.prg_rom_size) && (0 != header_buffer[ROM_LOADER_HEADER_PRG_ROM_SIZE_LSB_OFFSET])) ||
+            ((0 == parsed_header.chr_rom_size) && (0 != header_buffer[ROM_LOADER_HEADER_CHR_ROM_SIZE_LSB_OFFSET]))) {
+            status = PENES_STATUS_ROM_LOADER_PARSE_HEADER_INVALID_ROM_SIZE;
+            DEBUG_PRINT_WITH_ARGS("Invalid NES 2.0 ROM size. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    } else {
+        parsed_header.prg_rom_size = header_buffer[ROM_LOADER_HEADER_PRG_ROM_SIZE_LSB_OFFSET] * ROM_LOADER_PRG_ROM_BANK_SIZE;
+        parsed_header.chr_rom_size = header_buffer[ROM_LOADER_HEADER_CHR_ROM_SIZE_LSB_OFFSET] * ROM_LOADER_CHR_ROM_BANK_SIZE;
+
+        /* Old dumping tools wrote their name over the end of the header,
+         * in which case the high nibble of the mapper number in flags 7 is garbage as well.
+         * */
+        for (padding_index = ROM_LOADER_HEADER_PADDING_OFFSET; padding_index < ROM_LOADER_NES_FILE_HEADER_SIZE; padding_index++) {
+            if (0 != header_buffer[padding_index]) {
+                is_padding_clean = false;
+            }
+        }
+
+        if (true == is_padding_clean) {
+            parsed_header.mapper_number |= (flags_7 >> ROM_LOADER_NIBBLE_SIZE_BITS) << ROM_LOADER_NIBBLE_SIZE_BITS;
+            parsed_header.console_type = flags_7 & ROM_LOADER_FLAGS_7_CONSOLE_TYPE_MASK;
+        }
+
+        /* A PRG-RAM size of 0 is assumed to be a single unit, for compatibility, and CHR-RAM is present without CHR-ROM. */
+        parsed_header.prg_ram_size = MAX(
+            header_buffer[ROM_LOADER_HEADER_PRG_RAM_SIZE_OFFSET],
+            1
+        ) * ROM_LOADER_INES_PRG_RAM_UNIT_SIZE;
+        parsed_header.chr_ram_size = (0 == parsed_header.chr_rom_size)? ROM_LOADER_INES_CHR_RAM_SIZE: 0;
+    }
+
+    *output_header = parsed_header;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::setup_banks(const struct ROMLoaderHeader& parsed_header, std::size_t file_size)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t prg_rom_start = ROMLoader::get_prg_rom_start(parsed_header);
+    std::size_t chr_rom_start = 0;
+    std::size_t num_prg_rom_banks = 0;
+    std::size_t num_chr_rom_banks = 0;
+    std::size_t bank_index = 0;
+
+    chr_rom_start = prg_rom_start + parsed_header.prg_rom_size;
+
+    if (file_size < chr_rom_start + parsed_header.chr_rom_size) {
+        status = PENES_STATUS_ROM_LOADER_SETUP_BANKS_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The file is smaller than its ROM banks. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Compute the offset of every bank once, so that bank switches never need to parse or seek.
+     * A partial last bank, which only NES 2.0 sizes allow, is not addressable as a bank.
+     * */
+    num_prg_rom_banks = parsed_header.prg_rom_size / ROM_LOADER_PRG_ROM_BANK_SIZE;
+    num_chr_rom_banks = parsed_header.chr_rom_size / ROM_LOADER_CHR_ROM_BANK_SIZE;
+
+    this->prg_rom_bank_offsets.resize(num_prg_rom_banks);
+    for (bank_index = 0; bank_index < num_prg_rom_banks; bank_index++) {
+        this->prg_rom_bank_offsets[bank_index] = prg_rom_start + (bank_index * ROM_LOADER_PRG_ROM_BANK_SIZE);
+    }
+
+    this->chr_rom_bank_offsets.resize(num_chr_rom_banks);
+    for (bank_index = 0; bank_index < num_chr_rom_banks; bank_index++) {
+        this->chr_rom_bank_offsets[bank_index] = chr_rom_start + (bank_index * ROM_LOADER_CHR_ROM_BANK_SIZE);
+    }
+
+    this->header = parsed_header;
+    this->image_size = chr_rom_start + parsed_header.chr_rom_size;
 
     status = PENES_STATUS_SUCCESS;
 l_cleanup:
@@ -109,14 +551,26 @@ enum PeNESStatus ROMLoader::get_prg_rom_bank(std::size_t bank_index, char *bank_
     ASSERT(nullptr != bank_buffer);
 
     /* Verify the bank index is within bounds of the open file. */
-    if (this->num_prg_rom_banks <= bank_index) {
+    if (this->prg_rom_bank_offsets.size() <= bank_index) {
         status = PENES_STATUS_LOADER_GET_PRG_ROM_BANK_OUT_OF_BOUNDS;
         DEBUG_PRINT_WITH_ARGS("PRG-ROM index out of bounds. Status: %d.\n", status);
         goto l_cleanup;
     }
 
+    /* An image held in memory is copied from directly. */
+    if (nullptr != this->image_buffer) {
+        COPY_MEMORY(
+            bank_buffer,
+            this->image_buffer + this->prg_rom_bank_offsets[bank_index],
+            ROM_LOADER_PRG_ROM_BANK_SIZE
+        );
+
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
     /* Seek to the PRG-ROM location. */
-    input_file_stream.seekg(ROM_LOADER_NES_FILE_PRG_ROM_OFFSET + (ROM_LOADER_PRG_ROM_BANK_SIZE * bank_index));
+    input_file_stream.seekg(this->prg_rom_bank_offsets[bank_index]);
     if (true == input_file_stream.fail()) {
         status = PENES_STATUS_LOADER_GET_PRG_ROM_BANK_SEEKG_FAILED;
         DEBUG_PRINT_WITH_ARGS("seekg failed. Status: %d.\n", status);
@@ -135,3 +589,163 @@ enum PeNESStatus ROMLoader::get_prg_rom_bank(std::size_t bank_index, char *bank_
 l_cleanup:
     return status;
 }
+
+
+enum PeNESStatus ROMLoader::map_prg_rom_bank(std::size_t bank_index, native_word_t **output_bank)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    ASSERT(nullptr != output_bank);
+
+    if (false == this->is_image_in_place()) {
+        status = PENES_STATUS_ROM_LOADER_MAP_PRG_ROM_BANK_NOT_MAPPED;
+        DEBUG_PRINT_WITH_ARGS("The image is not used in place. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Verify the bank index is within bounds of the open file. */
+    if (this->prg_rom_bank_offsets.size() <= bank_index) {
+        status = PENES_STATUS_ROM_LOADER_MAP_PRG_ROM_BANK_OUT_OF_BOUNDS;
+        DEBUG_PRINT_WITH_ARGS("PRG-ROM index out of bounds. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    *output_bank = this->image_buffer + this->prg_rom_bank_offsets[bank_index];
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::map_file(const std::string& input_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    int input_file_descriptor = -1;
+    struct stat input_file_stat = {0};
+    void *input_file_mapping = MAP_FAILED;
+
+    input_file_descriptor = ::open(input_file.c_str(), O_RDONLY);
+    if (-1 == input_file_descriptor) {
+        status = PENES_STATUS_ROM_LOADER_MAP_FILE_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (-1 == fstat(input_file_descriptor, &input_file_stat)) {
+        status = PENES_STATUS_ROM_LOADER_MAP_FILE_FSTAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("fstat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Verify that the file has not been truncated since its header was parsed, since banks are not read one by one. */
+    if (static_cast<std::size_t>(input_file_stat.st_size) < this->image_size) {
+        status = PENES_STATUS_ROM_LOADER_MAP_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The file is smaller than its ROM banks. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    /* Map the file read-only, so that all instances of the same ROM share a single page cache copy.
+     * The banks are never written to, since the PRG-ROM regions drop writes, see ROMMemoryStorage.
+     * */
+    input_file_mapping = mmap(
+        nullptr,
+        input_file_stat.st_size,
+        PROT_READ,
+        MAP_PRIVATE,
+        input_file_descriptor,
+        0
+    );
+    if (MAP_FAILED == input_file_mapping) {
+        status = PENES_STATUS_ROM_LOADER_MAP_FILE_MMAP_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("mmap failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->image_source = ROM_LOADER_IMAGE_SOURCE_MAPPED_FILE;
+    this->image_buffer = static_cast<native_word_t *>(input_file_mapping);
+    this->image_buffer_size = input_file_stat.st_size;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    /* The mapping holds its own reference to the file. */
+    if (-1 != input_file_descriptor) {
+        close(input_file_descriptor);
+    }
+
+    return status;
+}
+
+
+enum PeNESStatus ROMLoader::load_chr_rom()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::size_t chr_rom_size = this->chr_rom_bank_offsets.size() * ROM_LOADER_CHR_ROM_BANK_SIZE;
+    std::size_t num_tiles = chr_rom_size / ROM_LOADER_CHR_TILE_SIZE;
+    std::size_t tile_index = 0;
+
+    this->chr_rom.resize(chr_rom_size);
+    this->decoded_chr_tiles.resize(num_tiles * ROM_LOADER_DECODED_CHR_TILE_SIZE);
+
+    if (0 == chr_rom_size) {
+        status = PENES_STATUS_SUCCESS;
+        goto l_cleanup;
+    }
+
+    /* All CHR-ROM banks are consecutive, and so they are read at once. */
+    if (nullptr != this->image_buffer) {
+        COPY_MEMORY(this->chr_rom.data(), this->image_buffer + this->chr_rom_bank_offsets[0], chr_rom_size);
+    } else {
+        this->input_file_stream.seekg(this->chr_rom_bank_offsets[0]);
+        if (true == this->input_file_stream.fail()) {
+            status = PENES_STATUS_ROM_LOADER_LOAD_CHR_ROM_SEEKG_FAILED;
+            DEBUG_PRINT_WITH_ARGS("seekg failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        this->input_file_stream.read(reinterpret_cast<char *>(this->chr_rom.data()), chr_rom_size);
+        if (true == this->input_file_stream.fail()) {
+            status = PENES_STATUS_ROM_LOADER_LOAD_CHR_ROM_READ_FAILED;
+            DEBUG_PRINT_WITH_ARGS("read failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    for (tile_index = 0; tile_index < num_tiles; tile_index++) {
+        decode_chr_tile(
+            &this->chr_rom[tile_index * ROM_LOADER_CHR_TILE_SIZE],
+            &this->decoded_chr_tiles[tile_index * ROM_LOADER_DECODED_CHR_TILE_SIZE]
+        );
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void ROMLoader::close_image()
+{
+    switch (this->image_source) {
+    case ROM_LOADER_IMAGE_SOURCE_MAPPED_FILE:
+        munmap(this->image_buffer, this->image_buffer_size);
+        break;
+    case ROM_LOADER_IMAGE_SOURCE_OWNED_BUFFER:
+        delete[] this->image_buffer;
+        break;
+    default:
+        break;
+    }
+
+    this->image_source = ROM_LOADER_IMAGE_SOURCE_NONE;
+    this->image_buffer = nullptr;
+    this->image_buffer_size = 0;
+
+    /* Nothing of the previous image outlives it, so that a failed open does not leave its banks to be loaded. */
+    this->header = {};
+    this->prg_rom_bank_offsets.clear();
+    this->chr_rom_bank_offsets.clear();
+    this->image_size = 0;
+    this->chr_rom.clear();
+    this->decoded_chr_tiles.clear();
+}
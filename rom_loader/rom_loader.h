@@ -8,35 +8,254 @@
 #define __ROM_LOADER_H__
 
 /** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <fstream>
 #include <iostream>
+#include <vector>
 
 #include "penes_status.h"
+#include "common.h"
+#include "system.h"
 
 /** Constants *************************************************************/
-
+#define ROM_LOADER_NES_FILE_HEADER_SIZE (16)
+#define ROM_LOADER_NES_FILE_TRAINER_SIZE (512)
+#define ROM_LOADER_PRG_ROM_BANK_SIZE (0x4000)
+#define ROM_LOADER_CHR_ROM_BANK_SIZE (0x2000)
+#define ROM_LOADER_CHR_TILE_SIZE (16)
+#define ROM_LOADER_CHR_TILE_WIDTH (8)
+#define ROM_LOADER_CHR_TILE_HEIGHT (8)
+#define ROM_LOADER_DECODED_CHR_TILE_SIZE (ROM_LOADER_CHR_TILE_WIDTH * ROM_LOADER_CHR_TILE_HEIGHT)
+#define ROM_LOADER_NUM_CHR_TILES_PER_BANK (ROM_LOADER_CHR_ROM_BANK_SIZE / ROM_LOADER_CHR_TILE_SIZE)
 
 /** Macros ****************************************************************/
 /** Enums *****************************************************************/
+enum ROMLoaderMirroring {
+    ROM_LOADER_MIRRORING_NONE = -1,
+    ROM_LOADER_MIRRORING_HORIZONTAL = 0,
+    ROM_LOADER_MIRRORING_VERTICAL,
+    ROM_LOADER_MIRRORING_FOUR_SCREEN
+};
+
+/** @brief Where the ROM image banks are served from, when it is held in memory as a whole. */
+enum ROMLoaderImageSource {
+    ROM_LOADER_IMAGE_SOURCE_NONE = 0,
+    ROM_LOADER_IMAGE_SOURCE_MAPPED_FILE,
+    ROM_LOADER_IMAGE_SOURCE_OWNED_BUFFER,
+    ROM_LOADER_IMAGE_SOURCE_BORROWED_BUFFER
+};
+
 /** Typedefs **************************************************************/
 /** Structs ***************************************************************/
+/** @brief The cartridge description parsed from an iNES or NES 2.0 header. All sizes are in bytes. */
+struct ROMLoaderHeader {
+    bool is_nes2;
+    std::uint16_t mapper_number;
+    std::uint8_t submapper_number;
+    enum ROMLoaderMirroring mirroring;
+    bool has_battery;
+    bool has_trainer;
+    std::uint8_t console_type;
+    std::uint8_t timing_mode;
+    std::size_t prg_rom_size;
+    std::size_t chr_rom_size;
+    std::size_t prg_ram_size;
+    std::size_t prg_nvram_size;
+    std::size_t chr_ram_size;
+    std::size_t chr_nvram_size;
+};
+
 /** Functions *************************************************************/
 class ROMLoader {
 public:
-    enum PeNESStatus open(const std::string& input_file);
+    inline ~ROMLoader()
+    {
+        this->close_image();
+    }
+
+    /** @brief          Open an iNES or NES 2.0 file and parse its header.
+     *                  The file offset of every PRG-ROM and CHR-ROM bank is computed once,
+     *                  so that banks can later be located without parsing or seeking.
+     *
+     *  @param[in]      input_file                  The path of the file.
+     *  @param[in]      is_memory_mapped            Whether to map the file into memory,
+     *                                              so that banks can be used in place rather than read.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           A gzip compressed file is decompressed straight into an owned image buffer,
+     *                  whose banks are then used in place regardless of is_memory_mapped.
+     * */
+    enum PeNESStatus open(const std::string& input_file, bool is_memory_mapped = false);
+
+    /** @brief          Open an iNES or NES 2.0 file whose header has already been parsed, without parsing it again.
+     *
+     *  @param[in]      input_file                  The path of the file.
+     *  @param[in]      known_header                The header previously parsed from the file, such as by an index.
+     *  @param[in]      is_memory_mapped            Whether to map the file into memory.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus open_with_header(
+        const std::string& input_file,
+        const struct ROMLoaderHeader& known_header,
+        bool is_memory_mapped = false
+    );
+
+    /** @brief          Open an iNES or NES 2.0 image held in memory, such as a generated or mutated ROM,
+     *                  with the same validation as a file.
+     *
+     *  @param[in]      image_buffer                The image, including the header.
+     *  @param[in]      image_buffer_size           The size of the image.
+     *  @param[in]      is_owned                    Whether the loader takes ownership of the buffer,
+     *                                              which must then have been allocated with new[].
+     *                                              An owned buffer is used in place, like a memory mapped file,
+     *                                              and is deleted when the loader is closed, reopened or fails to open.
+     *                                              A borrowed buffer must outlive the loader, and is only copied from.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    enum PeNESStatus open_from_buffer(const std::uint8_t *image_buffer, std::size_t image_buffer_size, bool is_owned = false);
+
+    /** @brief          Parse an iNES or NES 2.0 header.
+     *
+     *  @param[in]      header_buffer               The ROM_LOADER_NES_FILE_HEADER_SIZE bytes of the header.
+     *  @param[out]     output_header               The parsed header.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus parse_header(const std::uint8_t *header_buffer, struct ROMLoaderHeader *output_header);
+
+    /** @brief Retrieve the file offset of the PRG-ROM, which follows the header and the optional trainer.
+     *         The CHR-ROM immediately follows the PRG-ROM.
+     * */
+    static inline std::size_t get_prg_rom_start(const struct ROMLoaderHeader& parsed_header)
+    {
+        return ROM_LOADER_NES_FILE_HEADER_SIZE + ((true == parsed_header.has_trainer)? ROM_LOADER_NES_FILE_TRAINER_SIZE: 0);
+    }
 
     enum PeNESStatus get_prg_rom_bank(std::size_t bank_index, char *bank_buffer);
 
+    /** @brief          Retrieve a PRG-ROM bank in place, without copying it.
+     *
+     *  @param[in]      bank_index                  The index of the bank.
+     *  @param[out]     output_bank                 The bank within the file mapping.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           Only available when the image is used in place, see is_image_in_place.
+     *                  The bank remains valid until the loader is closed or reopened.
+     *                  The bank is shared by every user of the loader, and must not be written to.
+     * */
+    enum PeNESStatus map_prg_rom_bank(std::size_t bank_index, native_word_t **output_bank);
+
+    inline bool is_memory_mapped() const
+    {
+        return ROM_LOADER_IMAGE_SOURCE_MAPPED_FILE == this->image_source;
+    }
+
+    /** @brief Check whether the banks can be used in place, from a memory mapped file or an owned buffer. */
+    inline bool is_image_in_place() const
+    {
+        return (ROM_LOADER_IMAGE_SOURCE_MAPPED_FILE == this->image_source) ||
+               (ROM_LOADER_IMAGE_SOURCE_OWNED_BUFFER == this->image_source);
+    }
+
     inline std::size_t get_num_prg_rom_banks() const
     {
-        return this->num_prg_rom_banks;
+        return this->prg_rom_bank_offsets.size();
+    }
+
+    inline std::size_t get_num_chr_rom_banks() const
+    {
+        return this->chr_rom_bank_offsets.size();
+    }
+
+    /** @brief Retrieve the file offset of a PRG-ROM bank, which must be within bounds. */
+    inline std::size_t get_prg_rom_bank_offset(std::size_t bank_index) const
+    {
+        ASSERT(this->prg_rom_bank_offsets.size() > bank_index);
+
+        return this->prg_rom_bank_offsets[bank_index];
+    }
+
+    /** @brief Retrieve the file offset of a CHR-ROM bank, which must be within bounds. */
+    inline std::size_t get_chr_rom_bank_offset(std::size_t bank_index) const
+    {
+        ASSERT(this->chr_rom_bank_offsets.size() > bank_index);
+
+        return this->chr_rom_bank_offsets[bank_index];
+    }
+
+    /** @brief Retrieve the raw CHR-ROM, which holds get_num_chr_rom_banks() banks. */
+    inline const native_word_t *get_chr_rom() const
+    {
+        return this->chr_rom.data();
+    }
+
+    inline std::size_t get_num_chr_tiles() const
+    {
+        return this->decoded_chr_tiles.size() / ROM_LOADER_DECODED_CHR_TILE_SIZE;
+    }
+
+    /** @brief          Retrieve a pre-decoded CHR-ROM tile.
+     *
+     *  @param[in]      tile_index                  The index of the tile across all CHR-ROM banks.
+     *
+     *  @return         ROM_LOADER_DECODED_CHR_TILE_SIZE palette indices (0-3), one per pixel,
+     *                  row by row from the top left pixel.
+     *                  Each row of ROM_LOADER_CHR_TILE_WIDTH pixels can therefore be fetched with a single load.
+     * */
+    inline const native_word_t *get_decoded_chr_tile(std::size_t tile_index) const
+    {
+        ASSERT(this->get_num_chr_tiles() > tile_index);
+
+        return &this->decoded_chr_tiles[tile_index * ROM_LOADER_DECODED_CHR_TILE_SIZE];
+    }
+
+    inline const struct ROMLoaderHeader& get_header() const
+    {
+        return this->header;
+    }
+
+    /** @brief Whether the cartridge contains battery-backed SRAM, which should persist across runs. */
+    inline bool is_battery_backed() const
+    {
+        return this->header.has_battery;
     }
 
 private:
-    std::size_t num_prg_rom_banks = 0;
-    std::size_t num_chr_rom_banks = 0;
+    enum PeNESStatus open_file(
+        const std::string& input_file,
+        const struct ROMLoaderHeader *known_header,
+        bool is_memory_mapped
+    );
+
+    enum PeNESStatus open_gzip_file(const std::string& input_file, const struct ROMLoaderHeader *known_header);
+
+    enum PeNESStatus setup_banks(const struct ROMLoaderHeader& parsed_header, std::size_t file_size);
+
+    enum PeNESStatus map_file(const std::string& input_file);
+
+    enum PeNESStatus load_chr_rom();
+
+    void close_image();
+
+    struct ROMLoaderHeader header = {};
+    std::vector<std::size_t> prg_rom_bank_offsets;
+    std::vector<std::size_t> chr_rom_bank_offsets;
+    std::size_t image_size = 0;
+    std::vector<native_word_t> chr_rom;
+    std::vector<native_word_t> decoded_chr_tiles;
     std::ifstream input_file_stream;
+    /* The whole image, when it is held in memory rather than read through the stream.
+     * A borrowed buffer is never written to, since its banks are only copied from.
+     * */
+    enum ROMLoaderImageSource image_source = ROM_LOADER_IMAGE_SOURCE_NONE;
+    native_word_t *image_buffer = nullptr;
+    std::size_t image_buffer_size = 0;
 };
 
 
@@ -0,0 +1,268 @@
+/**
+ * @brief  Concurrent validation of a ROM library.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "gzip_reader/gzip_reader.h"
+#include "memory_map/memory_map.h"
+#include "rom_index/rom_index.h"
+#include "utils/json.h"
+#include "utils/thread_pool.h"
+
+#include "rom_scanner/rom_scanner.h"
+
+/** Constants *************************************************************/
+/* The reset vector is at the end of the last PRG-ROM bank, which is mapped to the upper half of PRG-ROM space. */
+#define ROM_SCANNER_RESET_VECTOR_BANK_OFFSET \
+    (MEMORY_MAP_ADDRESS_START_RESET_JUMP_VECTOR - MEMORY_MAP_ADDRESS_START_PRG_ROM_UPPER)
+#define ROM_SCANNER_ADDRESS_DIGITS (4)
+
+/** Functions *************************************************************/
+enum PeNESStatus ROMScanner::scan(
+    const std::vector<std::string>& directories,
+    std::size_t num_threads,
+    std::vector<struct ROMScanResult> *output_results
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::vector<std::string> rom_files;
+    std::vector<struct ROMScanResult> results;
+    std::size_t rom_file_index = 0;
+
+    ASSERT(nullptr != output_results);
+
+    for (const std::string& directory : directories) {
+        status = ROMIndex::find_rom_files(directory, &rom_files);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("find_rom_files failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    /* Sort the files so that the report does not depend on the order of the directory entries. */
+    std::sort(rom_files.begin(), rom_files.end());
+    results.resize(rom_files.size());
+
+    /* Each task writes only the result of its own file, and so the results need no locking.
+     * The pool is destroyed at the end of the block, after every task has finished.
+     * */
+    {
+        utils::ThreadPool thread_pool(num_threads);
+
+        for (rom_file_index = 0; rom_file_index < rom_files.size(); rom_file_index++) {
+            thread_pool.submit([&rom_files, &results, rom_file_index]() {
+                ROMScanner::scan_rom_file(rom_files[rom_file_index], &results[rom_file_index]);
+            });
+        }
+
+        thread_pool.wait();
+    }
+
+    *output_results = std::move(results);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void ROMScanner::scan_rom_file(const std::string& rom_file, struct ROMScanResult *output_result)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    struct ROMScanResult result = {};
+    struct stat rom_file_stat = {0};
+    std::ifstream rom_file_stream;
+    GzipReader gzip_reader;
+    std::size_t num_read = 0;
+    std::size_t decompressed_size = 0;
+    std::uint8_t header_buffer[ROM_LOADER_NES_FILE_HEADER_SIZE] = {0};
+    ROMLoader rom_loader;
+    char prg_rom_bank[ROM_LOADER_PRG_ROM_BANK_SIZE] = {0};
+    native_address_t reset_vector = 0;
+
+    ASSERT(nullptr != output_result);
+
+    result.path = rom_file;
+
+    if (-1 == stat(rom_file.c_str(), &rom_file_stat)) {
+        status = PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_STAT_FAILED;
+        DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("stat failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    result.file_size = rom_file_stat.st_size;
+    result.is_compressed = GzipReader::is_gzip_file(rom_file);
+
+    /* Check the header. A compressed file is checked by its decompressed image,
+     * whose size is taken from the trailer and only verified once the ROM loader decompresses it.
+     * */
+    if (true == result.is_compressed) {
+        status = GzipReader::get_decompressed_size(rom_file, &decompressed_size);
+        if (PENES_STATUS_SUCCESS == status) {
+            status = gzip_reader.open(rom_file);
+        }
+
+        if (PENES_STATUS_SUCCESS == status) {
+            status = gzip_reader.read(header_buffer, sizeof(header_buffer), &num_read);
+        }
+
+        if ((PENES_STATUS_SUCCESS != status) || (sizeof(header_buffer) > num_read)) {
+            status = PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_READ_HEADER_FAILED;
+            DEBUG_PRINT_WITH_ARGS("Failed to decompress the file header. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        result.file_size = decompressed_size;
+    } else {
+        rom_file_stream.open(rom_file, std::ifstream::in | std::ifstream::binary);
+        rom_file_stream.read(reinterpret_cast<char *>(header_buffer), sizeof(header_buffer));
+        if (true == rom_file_stream.fail()) {
+            status = PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_READ_HEADER_FAILED;
+            DEBUG_PRINT_WITH_ARGS("Failed to read the file header. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+
+        rom_file_stream.close();
+    }
+
+    status = ROMLoader::parse_header(header_buffer, &result.header);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("parse_header failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    result.is_header_valid = true;
+
+    /* Check the sizes declared by the header against the file size.
+     * Trailing data after the ROM banks is allowed, as many dumps carry it.
+     * */
+    result.expected_size = ROMLoader::get_prg_rom_start(result.header) +
+                           result.header.prg_rom_size +
+                           result.header.chr_rom_size;
+    if (result.file_size < result.expected_size) {
+        status = PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_TRUNCATED_FILE;
+        DEBUG_PRINT_WITH_ARGS("The file is smaller than its ROM banks. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    result.is_size_valid = true;
+
+    /* Check that the reset vector of the last PRG-ROM bank points into PRG-ROM space. */
+    status = rom_loader.open(rom_file);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = rom_loader.get_prg_rom_bank(rom_loader.get_num_prg_rom_banks() - 1, prg_rom_bank);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("get_prg_rom_bank failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    COPY_MEMORY(&reset_vector, &prg_rom_bank[ROM_SCANNER_RESET_VECTOR_BANK_OFFSET], sizeof(reset_vector));
+    result.reset_vector = system_native_to_host_endianness(reset_vector);
+    if (MEMORY_MAP_ADDRESS_START_PRG_ROM_LOWER > result.reset_vector) {
+        status = PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_INVALID_RESET_VECTOR;
+        DEBUG_PRINT_WITH_ARGS("The reset vector is outside of PRG-ROM. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    result.is_reset_vector_valid = true;
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    result.status = status;
+    *output_result = std::move(result);
+}
+
+
+enum PeNESStatus ROMScanner::write_report(
+    const std::vector<struct ROMScanResult>& results,
+    const std::string& report_file
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::ofstream output_stream;
+    std::size_t num_valid = 0;
+    std::size_t result_index = 0;
+
+    output_stream.open(report_file, std::ofstream::out | std::ofstream::trunc);
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_ROM_SCANNER_WRITE_REPORT_OPEN_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to open the report file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    for (const struct ROMScanResult& result : results) {
+        if (PENES_STATUS_SUCCESS == result.status) {
+            num_valid++;
+        }
+    }
+
+    output_stream << "{\n"
+                  << "  \"version\": " << ROM_SCANNER_REPORT_VERSION << ",\n"
+                  << "  \"num_roms\": " << results.size() << ",\n"
+                  << "  \"num_valid\": " << num_valid << ",\n"
+                  << "  \"roms\": [";
+
+    for (result_index = 0; result_index < results.size(); result_index++) {
+        const struct ROMScanResult& result = results[result_index];
+
+        output_stream << ((0 == result_index)? "\n": ",\n") << "    {\"path\": ";
+        utils::write_json_string(output_stream, result.path);
+        output_stream << ", \"valid\": " << utils::json_bool(PENES_STATUS_SUCCESS == result.status)
+                      << ", \"status\": " << result.status
+                      << ", \"checks\": {\"header\": " << utils::json_bool(result.is_header_valid)
+                      << ", \"size\": " << utils::json_bool(result.is_size_valid)
+                      << ", \"reset_vector\": " << utils::json_bool(result.is_reset_vector_valid) << '}'
+                      << ", \"compressed\": " << utils::json_bool(result.is_compressed)
+                      << ", \"file_size\": " << result.file_size;
+
+        if (true == result.is_header_valid) {
+            output_stream << ", \"expected_size\": " << result.expected_size
+                          << ", \"nes2\": " << utils::json_bool(result.header.is_nes2)
+                          << ", \"mapper\": " << result.header.mapper_number
+                          << ", \"prg_rom_size\": " << result.header.prg_rom_size
+                          << ", \"chr_rom_size\": " << result.header.chr_rom_size;
+        }
+
+        if ((true == result.is_reset_vector_valid) ||
+            (PENES_STATUS_ROM_SCANNER_SCAN_ROM_FILE_INVALID_RESET_VECTOR == result.status)) {
+            output_stream << ", \"reset_vector\": \"0x"
+                          << std::hex << std::uppercase
+                          << std::setw(ROM_SCANNER_ADDRESS_DIGITS) << std::setfill('0') << result.reset_vector
+                          << std::dec << '"';
+        }
+
+        output_stream << '}';
+    }
+
+    output_stream << "\n  ]\n}\n";
+
+    output_stream.flush();
+    if (true == output_stream.fail()) {
+        status = PENES_STATUS_ROM_SCANNER_WRITE_REPORT_WRITE_FAILED;
+        DEBUG_PRINT_WITH_ARGS("Failed to write the report file. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
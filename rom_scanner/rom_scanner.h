@@ -0,0 +1,85 @@
+/**
+ * @brief  Concurrent validation of a ROM library.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __ROM_SCANNER_H__
+#define __ROM_SCANNER_H__
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "penes_status.h"
+#include "system.h"
+
+#include "rom_loader/rom_loader.h"
+
+/** Constants *************************************************************/
+#define ROM_SCANNER_REPORT_VERSION (1)
+
+/** Structs ***************************************************************/
+/** @brief The validation result of a single ROM file. */
+struct ROMScanResult {
+    std::string path;
+    /* The status of the first failed check, or PENES_STATUS_SUCCESS if the ROM is valid. */
+    enum PeNESStatus status;
+    bool is_header_valid;
+    bool is_size_valid;
+    bool is_reset_vector_valid;
+    /* Whether the file is gzip compressed, in which case the file size is the size of the decompressed image. */
+    bool is_compressed;
+    std::uint64_t file_size;
+    /* The size of the header, trainer and ROM banks declared by the header. */
+    std::uint64_t expected_size;
+    struct ROMLoaderHeader header;
+    native_address_t reset_vector;
+};
+
+/** Classes ***************************************************************/
+class ROMScanner {
+public:
+    /** @brief          Validate every ROM file in the directory trees concurrently.
+     *
+     *  @param[in]      directories                 The roots of the directory trees.
+     *  @param[in]      num_threads                 The number of worker threads,
+     *                                              or 0 for the number of hardware threads.
+     *  @param[out]     output_results              The results of the ROM files, sorted by path.
+     *
+     *  @return         Status indicating the success of the operation.
+     *
+     *  @note           A ROM failing validation does not fail the scan, it is only reported in its result.
+     * */
+    static enum PeNESStatus scan(
+        const std::vector<std::string>& directories,
+        std::size_t num_threads,
+        std::vector<struct ROMScanResult> *output_results
+    );
+
+    /** @brief          Validate a single ROM file.
+     *                  The header is checked first, then the declared sizes against the file size,
+     *                  and finally that the reset vector points into PRG-ROM.
+     *
+     *  @param[in]      rom_file                    The path of the ROM file.
+     *  @param[out]     output_result               The result of the ROM file.
+     * */
+    static void scan_rom_file(const std::string& rom_file, struct ROMScanResult *output_result);
+
+    /** @brief          Write the results as a JSON report.
+     *
+     *  @param[in]      results                     The results to report.
+     *  @param[in]      report_file                 The path of the report file to create.
+     *
+     *  @return         Status indicating the success of the operation.
+     * */
+    static enum PeNESStatus write_report(
+        const std::vector<struct ROMScanResult>& results,
+        const std::string& report_file
+    );
+};
+
+
+#endif /* __ROM_SCANNER_H__ */
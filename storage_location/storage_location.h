@@ -31,7 +31,7 @@ public:
         }
     }
 
-    inline ~IStorageLocation()
+    inline virtual ~IStorageLocation()
     {
         if (0 < this->storage_size) {
             delete[] this->storage_buffer;
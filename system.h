@@ -36,6 +36,24 @@ typedef std::uint16_t native_dword_t;
 typedef std::int16_t native_signed_dword_t;
 typedef native_dword_t native_address_t;
 
+/** Structs ***************************************************************/
+/** @brief CPU variant policies. The variant is fixed at compile time, and so its checks cost nothing at run time. */
+struct SystemCPUVariant2A03 {
+    /* The NES CPU is a 6502 with the decimal mode circuitry disconnected. The flag can be set, but ADC and SBC ignore it. */
+    static constexpr bool has_decimal_mode = false;
+};
+
+struct SystemCPUVariant6502 {
+    static constexpr bool has_decimal_mode = true;
+};
+
+/* The NES build targets the 2A03, while other 6502 targets can select the generic variant. */
+#ifdef PENES_CPU_VARIANT_6502
+typedef struct SystemCPUVariant6502 system_cpu_variant_t;
+#else
+typedef struct SystemCPUVariant2A03 system_cpu_variant_t;
+#endif
+
 
 /** Functions *************************************************************/
 static bool system_is_host_little_endian()
@@ -0,0 +1,507 @@
+/**
+ * @brief  Run a batch of emulation jobs concurrently, and stream their results as JSON lines.
+ * @author agent
+ * @date   19/10/2026
+ *
+ * Usage:   penes-batch [--threads <num_threads> | --lockstep] <jobs_file>
+ *
+ * Every line of the jobs file is a job, made of tab separated fields:
+ *          <rom_file>  <movie_file>  <num_frames>
+ * where the movie file is "-" for a job without input. Empty lines and lines starting with '#' are skipped.
+ *
+ * With --lockstep, the jobs run on the calling thread as the lanes of a single lockstep engine, a frame at a time,
+ * which suits many jobs of the same ROM. The elapsed time of a job is then that of the engine frames it ran in,
+ * and the stats of the engine are written to stderr as JSON once every job finished.
+ * Lockstep mode is experimental: it is still slower than running the same jobs one after another on a single thread.
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "penes_status.h"
+#include "common.h"
+#include "system.h"
+
+#include "controller/standard_controller.h"
+#include "cpu/cpu.h"
+#include "input_movie/input_movie.h"
+#include "lockstep_engine/lockstep_engine.h"
+#include "program_context/program_context.h"
+#include "rom_loader/rom_loader.h"
+#include "utils/checksum.h"
+#include "utils/json.h"
+#include "utils/thread_pool.h"
+#include "utils/utils.h"
+
+/** Constants *************************************************************/
+#define PENES_BATCH_THREADS_OPTION ("--threads")
+#define PENES_BATCH_LOCKSTEP_OPTION ("--lockstep")
+#define PENES_BATCH_NO_MOVIE ("-")
+#define PENES_BATCH_JOB_FIELD_SEPARATOR ('\t')
+#define PENES_BATCH_COMMENT_PREFIX ('#')
+#define PENES_BATCH_CARRIAGE_RETURN ('\r')
+#define PENES_BATCH_CRC32_DIGITS (8)
+/* The internal RAM, without its mirrors. */
+#define PENES_BATCH_RAM_SIZE (MEMORY_MAP_ADDRESS_START_RAM_MIRROR)
+
+/** Structs ***************************************************************/
+struct BatchJob {
+    std::string rom_file;
+    std::string movie_file;
+    std::size_t num_frames;
+};
+
+struct BatchJobResult {
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint64_t num_instructions = 0;
+    std::uint64_t num_cycles = 0;
+    std::uint64_t num_frames = 0;
+    double elapsed_seconds = 0;
+    /* The CRC-32 of the internal RAM at the end of the job, to compare runs of the same job. */
+    std::uint32_t ram_crc32 = 0;
+};
+
+/** Classes ***************************************************************/
+/** @brief A job in progress, which runs on a machine of its own, a frame at a time.
+ *         Only the stateless opcode and address mode objects are shared with the other jobs, and the ROM image is
+ *         a private mapping of the file, which shares its pages until written.
+ * */
+class BatchJobRun {
+public:
+    inline explicit BatchJobRun(const struct BatchJob *job): job(job)
+    {
+        ASSERT(nullptr != job);
+    }
+
+    inline ~BatchJobRun()
+    {
+        delete this->emulator;
+        delete this->program_ctx;
+    }
+
+    BatchJobRun(const BatchJobRun&) = delete;
+    BatchJobRun& operator=(const BatchJobRun&) = delete;
+
+    /** @brief Run the next slice of the job, which starts the machine on the first slice, and runs a frame after. */
+    enum PeNESStatus run_slice();
+
+    inline bool is_finished() const
+    {
+        return (nullptr != this->emulator) && (this->frame_index >= this->job->num_frames);
+    }
+
+    /** @brief Retrieve the machine of a started job, for a frame to be run on it by other means than run_slice. */
+    inline CPU *get_emulator()
+    {
+        return this->emulator;
+    }
+
+    /** @brief Hold the buttons of the job's next frame. */
+    void begin_frame();
+
+    /** @brief          Complete the job's next frame, once it was run.
+     *
+     *  @param[in]      frame_time_ns               The time spent running the frame.
+     * */
+    inline void end_frame(std::uint64_t frame_time_ns)
+    {
+        this->running_time_ns += frame_time_ns;
+        this->frame_index++;
+    }
+
+    /** @brief Retrieve the result of a finished job. */
+    void get_result(struct BatchJobResult *output_result);
+
+private:
+    enum PeNESStatus start();
+
+    const struct BatchJob *job;
+    ROMLoader rom_loader;
+    InputMovie input_movie;
+    StandardController controller;
+    ProgramContext *program_ctx = nullptr;
+    CPU *emulator = nullptr;
+    std::size_t frame_index = 0;
+    /* The time spent running the job's frames, which leaves out the time it waited between its slices. */
+    std::uint64_t running_time_ns = 0;
+};
+
+/** Functions *************************************************************/
+static void print_usage(const char *program_name)
+{
+    std::cerr << "Usage: " << program_name << " [" << PENES_BATCH_THREADS_OPTION << " <num_threads> | "
+              << PENES_BATCH_LOCKSTEP_OPTION << "] <jobs_file>" << std::endl
+              << "  " << PENES_BATCH_LOCKSTEP_OPTION
+              << "  Experimental: run the jobs as the lanes of a single lockstep engine, on the calling thread."
+              << std::endl;
+}
+
+
+static bool read_jobs(const char *jobs_file, std::vector<struct BatchJob> *output_jobs)
+{
+    std::ifstream jobs_stream(jobs_file);
+    std::string line;
+    std::string num_frames_field;
+    struct BatchJob job;
+
+    ASSERT(nullptr != output_jobs);
+
+    if (true == jobs_stream.fail()) {
+        std::cerr << "Failed to open " << jobs_file << std::endl;
+        return false;
+    }
+
+    while (true == static_cast<bool>(std::getline(jobs_stream, line))) {
+        /* A jobs file written with CRLF line endings leaves the carriage return at the end of the line. */
+        if ((false == line.empty()) && (PENES_BATCH_CARRIAGE_RETURN == line.back())) {
+            line.pop_back();
+        }
+
+        if ((true == line.empty()) || (PENES_BATCH_COMMENT_PREFIX == line[0])) {
+            continue;
+        }
+
+        std::istringstream line_stream(line);
+        if ((false == static_cast<bool>(std::getline(line_stream, job.rom_file, PENES_BATCH_JOB_FIELD_SEPARATOR))) ||
+            (false == static_cast<bool>(std::getline(line_stream, job.movie_file, PENES_BATCH_JOB_FIELD_SEPARATOR))) ||
+            (false == static_cast<bool>(std::getline(line_stream, num_frames_field, PENES_BATCH_JOB_FIELD_SEPARATOR))) ||
+            (PENES_STATUS_SUCCESS != utils::parse_size(num_frames_field.c_str(), &job.num_frames))) {
+            std::cerr << "Invalid job: " << line << std::endl;
+            return false;
+        }
+
+        output_jobs->push_back(job);
+    }
+
+    return true;
+}
+
+
+enum PeNESStatus BatchJobRun::start()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+
+    status = this->rom_loader.open(this->job->rom_file, true);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("open failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    if (PENES_BATCH_NO_MOVIE != this->job->movie_file) {
+        status = this->input_movie.load(this->job->movie_file);
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("load failed. Status: %d.\n", status);
+            goto l_cleanup;
+        }
+    }
+
+    this->program_ctx = new ProgramContext(&this->rom_loader);
+    status = this->program_ctx->attach_peripheral(MEMORY_MAP_ADDRESS_START_IO_REGISTERS_2, &this->controller);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("attach_peripheral failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->emulator = new CPU(this->program_ctx);
+    status = this->emulator->reset();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("reset failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+enum PeNESStatus BatchJobRun::run_slice()
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    std::uint64_t start_time_ns = 0;
+    std::uint64_t end_time_ns = 0;
+
+    if (nullptr == this->emulator) {
+        status = this->start();
+        if (PENES_STATUS_SUCCESS != status) {
+            DEBUG_PRINT_WITH_ARGS("start failed. Status: %d.\n", status);
+        }
+
+        goto l_cleanup;
+    }
+
+    status = CPU::get_monotonic_time(&start_time_ns);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->begin_frame();
+
+    status = this->emulator->step_frame();
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("step_frame failed. Status: %d. Frame: %zu.\n", status, this->frame_index);
+        goto l_cleanup;
+    }
+
+    status = CPU::get_monotonic_time(&end_time_ns);
+    if (PENES_STATUS_SUCCESS != status) {
+        DEBUG_PRINT_WITH_ARGS("get_monotonic_time failed. Status: %d.\n", status);
+        goto l_cleanup;
+    }
+
+    this->end_frame(end_time_ns - start_time_ns);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
+
+void BatchJobRun::begin_frame()
+{
+    std::size_t port_index = 0;
+
+    /* The buttons of each frame are held throughout it, and latched whenever the game strobes the controllers. */
+    for (port_index = 0; port_index < STANDARD_CONTROLLER_NUM_PORTS; port_index++) {
+        this->controller.set_buttons(port_index, this->input_movie.get_buttons(this->frame_index, port_index));
+    }
+}
+
+
+void BatchJobRun::get_result(struct BatchJobResult *output_result)
+{
+    std::vector<native_word_t> address_space_snapshot(MEMORY_MAP_ADDRESS_SPACE_SIZE);
+
+    ASSERT(nullptr != output_result);
+    ASSERT(true == this->is_finished());
+
+    this->program_ctx->memory_map.save_snapshot(address_space_snapshot.data());
+
+    output_result->num_instructions = this->emulator->get_num_instructions();
+    output_result->num_cycles = this->emulator->get_num_cycles();
+    output_result->num_frames = this->emulator->get_num_frames();
+    output_result->elapsed_seconds = static_cast<double>(this->running_time_ns) / CPU_NANOSECONDS_PER_SECOND;
+    output_result->ram_crc32 = utils::calculate_crc32(address_space_snapshot.data(), PENES_BATCH_RAM_SIZE);
+}
+
+
+static void write_result(
+    std::ostream& output_stream,
+    std::size_t job_index,
+    const struct BatchJob& job,
+    const struct BatchJobResult& result
+)
+{
+    output_stream << "{\"job\": " << job_index << ", \"rom\": ";
+    utils::write_json_string(output_stream, job.rom_file);
+    output_stream << ", \"movie\": ";
+    if (PENES_BATCH_NO_MOVIE != job.movie_file) {
+        utils::write_json_string(output_stream, job.movie_file);
+    } else {
+        output_stream << "null";
+    }
+
+    output_stream << ", \"success\": " << utils::json_bool(PENES_STATUS_SUCCESS == result.status)
+                  << ", \"status\": " << result.status;
+
+    if (PENES_STATUS_SUCCESS == result.status) {
+        output_stream << ", \"frames\": " << result.num_frames
+                      << ", \"instructions\": " << result.num_instructions
+                      << ", \"cycles\": " << result.num_cycles
+                      << ", \"elapsed_seconds\": " << result.elapsed_seconds
+                      << ", \"speed_ratio\": "
+                      << ((0 < result.elapsed_seconds)?
+                          result.num_cycles / result.elapsed_seconds / CPU_NTSC_CLOCK_RATE_HZ:
+                          0)
+                      << ", \"ram_crc32\": \"" << std::hex << std::setw(PENES_BATCH_CRC32_DIGITS) << std::setfill('0')
+                      << result.ram_crc32 << std::dec << '"';
+    }
+
+    output_stream << '}';
+}
+
+
+/** @brief Collect the result of a job that finished or failed, release it, and write its result as a single line. */
+static void finish_job(
+    BatchJobRun *job_run,
+    std::size_t job_index,
+    const struct BatchJob& job,
+    struct BatchJobResult *result,
+    std::mutex *output_mutex
+)
+{
+    std::ostringstream line_stream;
+
+    ASSERT(nullptr != job_run);
+    ASSERT(nullptr != result);
+    ASSERT(nullptr != output_mutex);
+
+    if (PENES_STATUS_SUCCESS == result->status) {
+        job_run->get_result(result);
+    }
+
+    delete job_run;
+
+    write_result(line_stream, job_index, job, *result);
+
+    std::lock_guard<std::mutex> output_lock(*output_mutex);
+    std::cout << line_stream.str() << std::endl;
+}
+
+
+/** @brief Run the jobs as the lanes of a single lockstep engine, a frame at a time, and write the stats of the engine. */
+static void run_lockstep_jobs(
+    const std::vector<struct BatchJob>& jobs,
+    std::vector<struct BatchJobResult> *results,
+    std::mutex *output_mutex
+)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    LockstepEngine lockstep_engine;
+    struct LockstepEngineStats lockstep_stats;
+    std::vector<BatchJobRun *> job_runs(jobs.size(), nullptr);
+    std::size_t job_index = 0;
+    std::size_t num_running_jobs = 0;
+    std::uint64_t start_time_ns = 0;
+    std::uint64_t end_time_ns = 0;
+
+    ASSERT(nullptr != results);
+    ASSERT(nullptr != output_mutex);
+
+    /* The first slice of a job starts its machine, which then joins the engine, unless it failed or has no frames. */
+    for (job_index = 0; job_index < jobs.size(); job_index++) {
+        job_runs[job_index] = new BatchJobRun(&jobs[job_index]);
+
+        (*results)[job_index].status = job_runs[job_index]->run_slice();
+        if ((PENES_STATUS_SUCCESS == (*results)[job_index].status) && (false == job_runs[job_index]->is_finished())) {
+            lockstep_engine.add_lane(job_runs[job_index]->get_emulator());
+            num_running_jobs++;
+            continue;
+        }
+
+        finish_job(job_runs[job_index], job_index, jobs[job_index], &(*results)[job_index], output_mutex);
+        job_runs[job_index] = nullptr;
+    }
+
+    while (0 < num_running_jobs) {
+        for (BatchJobRun *job_run : job_runs) {
+            if (nullptr != job_run) {
+                job_run->begin_frame();
+            }
+        }
+
+        status = CPU::get_monotonic_time(&start_time_ns);
+        if (PENES_STATUS_SUCCESS == status) {
+            status = lockstep_engine.step_frame();
+        }
+        if (PENES_STATUS_SUCCESS == status) {
+            status = CPU::get_monotonic_time(&end_time_ns);
+        }
+
+        /* A failed frame fails every job that ran in it, since the engine runs their frames together. */
+        for (job_index = 0; job_index < jobs.size(); job_index++) {
+            if (nullptr == job_runs[job_index]) {
+                continue;
+            }
+
+            if (PENES_STATUS_SUCCESS == status) {
+                job_runs[job_index]->end_frame(end_time_ns - start_time_ns);
+                if (false == job_runs[job_index]->is_finished()) {
+                    continue;
+                }
+            } else {
+                (*results)[job_index].status = status;
+            }
+
+            lockstep_engine.remove_lane(job_runs[job_index]->get_emulator());
+            finish_job(job_runs[job_index], job_index, jobs[job_index], &(*results)[job_index], output_mutex);
+            job_runs[job_index] = nullptr;
+            num_running_jobs--;
+        }
+    }
+
+    lockstep_engine.get_stats(&lockstep_stats);
+    LockstepEngine::write_stats(lockstep_stats, std::cerr, true);
+}
+
+
+int main(int argc, char **argv)
+{
+    int argument_index = 1;
+    std::size_t num_threads = 0;
+    std::vector<struct BatchJob> jobs;
+    std::vector<struct BatchJobResult> results;
+    std::mutex output_mutex;
+    std::size_t job_index = 0;
+    bool is_lockstep = false;
+    int exit_code = 0;
+
+    /* The number of threads defaults to the number of hardware threads. */
+    if ((argument_index + 1 < argc) && (CMP_EQUAL == strcmp(PENES_BATCH_THREADS_OPTION, argv[argument_index]))) {
+        if (PENES_STATUS_SUCCESS != utils::parse_size(argv[argument_index + 1], &num_threads)) {
+            print_usage(argv[0]);
+            return -1;
+        }
+        argument_index += 2;
+    } else if ((argument_index < argc) && (CMP_EQUAL == strcmp(PENES_BATCH_LOCKSTEP_OPTION, argv[argument_index]))) {
+        is_lockstep = true;
+        argument_index++;
+    }
+
+    if (argument_index + 1 != argc) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    if (false == read_jobs(argv[argument_index], &jobs)) {
+        return -1;
+    }
+
+    results.resize(jobs.size());
+
+    /* Every result is written as a single line as soon as its job finishes, in the order the jobs finish. */
+    if (true == is_lockstep) {
+        run_lockstep_jobs(jobs, &results, &output_mutex);
+    } else {
+        /* Jobs yield after every frame, and a job that is waiting behind another is stolen by the first idle worker. */
+        utils::ThreadPool thread_pool(num_threads);
+
+        for (job_index = 0; job_index < jobs.size(); job_index++) {
+            BatchJobRun *job_run = new BatchJobRun(&jobs[job_index]);
+
+            thread_pool.submit_resumable([&jobs, &results, &output_mutex, job_index, job_run]() {
+                struct BatchJobResult *result = &results[job_index];
+
+                result->status = job_run->run_slice();
+                if ((PENES_STATUS_SUCCESS == result->status) && (false == job_run->is_finished())) {
+                    return false;
+                }
+
+                finish_job(job_run, job_index, jobs[job_index], result, &output_mutex);
+
+                return true;
+            });
+        }
+
+        thread_pool.wait();
+    }
+
+    for (const struct BatchJobResult& result : results) {
+        if (PENES_STATUS_SUCCESS != result.status) {
+            exit_code = -1;
+        }
+    }
+
+    return exit_code;
+}
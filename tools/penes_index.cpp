@@ -0,0 +1,103 @@
+/**
+ * @brief  Build or list a ROM library index.
+ * @author agent
+ * @date   19/10/2026
+ *
+ * Usage:   penes-index <index_file> <rom_directory>...
+ *          penes-index --list <index_file>
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "rom_index/rom_index.h"
+
+/** Constants *************************************************************/
+#define PENES_INDEX_LIST_OPTION ("--list")
+#define PENES_INDEX_MIN_ARGUMENTS (3)
+#define PENES_INDEX_CRC32_DIGITS (8)
+#define PENES_INDEX_HASH_DIGITS (16)
+
+/** Functions *************************************************************/
+static void print_usage(const char *program_name)
+{
+    std::cout << "Usage: " << program_name << " <index_file> <rom_directory>..." << std::endl
+              << "       " << program_name << " " << PENES_INDEX_LIST_OPTION << " <index_file>" << std::endl;
+}
+
+
+static int list_index(const char *index_file)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    ROMIndex rom_index;
+
+    status = rom_index.load(index_file);
+    if (PENES_STATUS_SUCCESS != status) {
+        std::cout << "Failed to load " << index_file << ". Status: " << status << std::endl;
+        return -1;
+    }
+
+    for (const struct ROMIndexEntry& entry : rom_index.get_entries()) {
+        std::cout << std::hex << std::setfill('0')
+                  << std::setw(PENES_INDEX_CRC32_DIGITS) << entry.prg_rom_crc32 << ' '
+                  << std::setw(PENES_INDEX_CRC32_DIGITS) << entry.chr_rom_crc32 << ' '
+                  << std::setw(PENES_INDEX_HASH_DIGITS) << entry.prg_rom_hash << ' '
+                  << std::setw(PENES_INDEX_HASH_DIGITS) << entry.chr_rom_hash << std::dec
+                  << " mapper " << entry.header.mapper_number
+                  << " prg " << entry.header.prg_rom_size
+                  << " chr " << entry.header.chr_rom_size
+                  << ' ' << entry.path << std::endl;
+    }
+
+    return 0;
+}
+
+
+static int build_index(const char *index_file, char *const *rom_directories, std::size_t num_rom_directories)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    ROMIndex rom_index;
+    std::size_t directory_index = 0;
+    std::size_t num_added = 0;
+    std::size_t num_skipped = 0;
+
+    for (directory_index = 0; directory_index < num_rom_directories; directory_index++) {
+        status = rom_index.scan_directory(rom_directories[directory_index], &num_added, &num_skipped);
+        if (PENES_STATUS_SUCCESS != status) {
+            std::cout << "Failed to scan " << rom_directories[directory_index] << ". Status: " << status << std::endl;
+            return -1;
+        }
+
+        std::cout << rom_directories[directory_index] << ": "
+                  << num_added << " indexed, " << num_skipped << " skipped" << std::endl;
+    }
+
+    status = rom_index.save(index_file);
+    if (PENES_STATUS_SUCCESS != status) {
+        std::cout << "Failed to save " << index_file << ". Status: " << status << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
+
+
+int main(int argc, char **argv)
+{
+    if (PENES_INDEX_MIN_ARGUMENTS > argc) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    if (CMP_EQUAL == strcmp(PENES_INDEX_LIST_OPTION, argv[1])) {
+        return list_index(argv[2]);
+    }
+
+    return build_index(argv[1], &argv[2], argc - 2);
+}
@@ -0,0 +1,81 @@
+/**
+ * @brief  Validate a ROM library concurrently, and write a JSON report.
+ * @author agent
+ * @date   19/10/2026
+ *
+ * Usage:   penes-scan [--threads <num_threads>] <report_file> <rom_directory>...
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "penes_status.h"
+#include "common.h"
+
+#include "rom_scanner/rom_scanner.h"
+#include "utils/utils.h"
+
+/** Constants *************************************************************/
+#define PENES_SCAN_THREADS_OPTION ("--threads")
+#define PENES_SCAN_MIN_ARGUMENTS (3)
+
+/** Functions *************************************************************/
+static void print_usage(const char *program_name)
+{
+    std::cout << "Usage: " << program_name << " [" << PENES_SCAN_THREADS_OPTION << " <num_threads>]"
+              << " <report_file> <rom_directory>..." << std::endl;
+}
+
+
+int main(int argc, char **argv)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    int argument_index = 1;
+    std::size_t num_threads = 0;
+    std::vector<std::string> rom_directories;
+    std::vector<struct ROMScanResult> results;
+    std::size_t num_valid = 0;
+
+    /* The number of threads defaults to the number of hardware threads. */
+    if ((argument_index + 1 < argc) && (CMP_EQUAL == strcmp(PENES_SCAN_THREADS_OPTION, argv[argument_index]))) {
+        if (PENES_STATUS_SUCCESS != utils::parse_size(argv[argument_index + 1], &num_threads)) {
+            print_usage(argv[0]);
+            return -1;
+        }
+        argument_index += 2;
+    }
+
+    if (PENES_SCAN_MIN_ARGUMENTS > argc - argument_index + 1) {
+        print_usage(argv[0]);
+        return -1;
+    }
+
+    rom_directories.assign(&argv[argument_index + 1], &argv[argc]);
+
+    status = ROMScanner::scan(rom_directories, num_threads, &results);
+    if (PENES_STATUS_SUCCESS != status) {
+        std::cout << "Failed to scan the ROM directories. Status: " << status << std::endl;
+        return -1;
+    }
+
+    status = ROMScanner::write_report(results, argv[argument_index]);
+    if (PENES_STATUS_SUCCESS != status) {
+        std::cout << "Failed to write " << argv[argument_index] << ". Status: " << status << std::endl;
+        return -1;
+    }
+
+    for (const struct ROMScanResult& result : results) {
+        if (PENES_STATUS_SUCCESS == result.status) {
+            num_valid++;
+        }
+    }
+
+    std::cout << num_valid << " of " << results.size() << " ROMs are valid" << std::endl;
+
+    return 0;
+}
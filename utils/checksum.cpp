@@ -0,0 +1,76 @@
+/**
+ * @brief  Checksums and hashes of buffers.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "common.h"
+
+#include "utils/checksum.h"
+
+/** Constants *************************************************************/
+#define CHECKSUM_CRC32_POLYNOMIAL (0xEDB88320)
+#define CHECKSUM_CRC32_FINAL_XOR (0xFFFFFFFF)
+#define CHECKSUM_CRC32_TABLE_SIZE (256)
+#define CHECKSUM_FNV1A_64_OFFSET_BASIS (0xCBF29CE484222325)
+#define CHECKSUM_FNV1A_64_PRIME (0x100000001B3)
+#define CHECKSUM_BYTE_SIZE_BITS (8)
+#define CHECKSUM_BYTE_MASK (0xFF)
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Functions *************************************************************/
+std::uint32_t calculate_crc32(const std::uint8_t *buffer, std::size_t buffer_size, std::uint32_t previous_crc32)
+{
+    /* The table is built once, on first use. */
+    static const std::array<std::uint32_t, CHECKSUM_CRC32_TABLE_SIZE> crc32_table = []() {
+        std::array<std::uint32_t, CHECKSUM_CRC32_TABLE_SIZE> table = {};
+        std::uint32_t remainder = 0;
+        std::size_t table_index = 0;
+        std::size_t bit_index = 0;
+
+        for (table_index = 0; table_index < CHECKSUM_CRC32_TABLE_SIZE; table_index++) {
+            remainder = static_cast<std::uint32_t>(table_index);
+            for (bit_index = 0; bit_index < CHECKSUM_BYTE_SIZE_BITS; bit_index++) {
+                remainder = (0 != (remainder & 1))? (remainder >> 1) ^ CHECKSUM_CRC32_POLYNOMIAL: (remainder >> 1);
+            }
+
+            table[table_index] = remainder;
+        }
+
+        return table;
+    }();
+    std::uint32_t crc32 = previous_crc32 ^ CHECKSUM_CRC32_FINAL_XOR;
+    std::size_t buffer_index = 0;
+
+    ASSERT((nullptr != buffer) || (0 == buffer_size));
+
+    for (buffer_index = 0; buffer_index < buffer_size; buffer_index++) {
+        crc32 = crc32_table[(crc32 ^ buffer[buffer_index]) & CHECKSUM_BYTE_MASK] ^ (crc32 >> CHECKSUM_BYTE_SIZE_BITS);
+    }
+
+    return crc32 ^ CHECKSUM_CRC32_FINAL_XOR;
+}
+
+
+std::uint64_t calculate_fnv1a_64(const std::uint8_t *buffer, std::size_t buffer_size)
+{
+    std::uint64_t hash = CHECKSUM_FNV1A_64_OFFSET_BASIS;
+    std::size_t buffer_index = 0;
+
+    ASSERT((nullptr != buffer) || (0 == buffer_size));
+
+    for (buffer_index = 0; buffer_index < buffer_size; buffer_index++) {
+        hash = (hash ^ buffer[buffer_index]) * CHECKSUM_FNV1A_64_PRIME;
+    }
+
+    return hash;
+}
+
+}
@@ -0,0 +1,34 @@
+/**
+ * @brief  Checksums and hashes of buffers.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __CHECKSUM_H__
+#define __CHECKSUM_H__
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <cstdint>
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Functions *************************************************************/
+/** @brief          Calculate the CRC-32 (IEEE 802.3) of a buffer.
+ *
+ *  @param[in]      buffer                      The buffer to checksum.
+ *  @param[in]      buffer_size                 The size of the buffer.
+ *  @param[in]      previous_crc32              The CRC-32 of the data preceding the buffer,
+ *                                              so that a stream can be checksummed in chunks.
+ *
+ *  @return         The CRC-32 of the preceding data followed by the buffer.
+ * */
+std::uint32_t calculate_crc32(const std::uint8_t *buffer, std::size_t buffer_size, std::uint32_t previous_crc32 = 0);
+
+/** @brief Calculate the 64-bit FNV-1a hash of a buffer. */
+std::uint64_t calculate_fnv1a_64(const std::uint8_t *buffer, std::size_t buffer_size);
+
+}
+
+#endif /* __CHECKSUM_H__ */
@@ -0,0 +1,42 @@
+/**
+ * @brief  Helpers for writing JSON reports.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include "utils/json.h"
+
+/** Constants *************************************************************/
+#define JSON_CONTROL_CHAR_LIMIT (0x20)
+#define JSON_ESCAPE_BUFFER_SIZE (sizeof("\\u0000"))
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Functions *************************************************************/
+void write_json_string(std::ostream& output_stream, const std::string& value)
+{
+    char escape_buffer[JSON_ESCAPE_BUFFER_SIZE] = {0};
+
+    output_stream << '"';
+
+    for (char value_char : value) {
+        if (('"' == value_char) || ('\\' == value_char)) {
+            output_stream << '\\' << value_char;
+        } else if (JSON_CONTROL_CHAR_LIMIT > static_cast<unsigned char>(value_char)) {
+            snprintf(escape_buffer, sizeof(escape_buffer), "\\u%04x", static_cast<unsigned char>(value_char));
+            output_stream << escape_buffer;
+        } else {
+            output_stream << value_char;
+        }
+    }
+
+    output_stream << '"';
+}
+
+}
@@ -0,0 +1,28 @@
+/**
+ * @brief  Helpers for writing JSON reports.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __JSON_H__
+#define __JSON_H__
+
+/** Headers ***************************************************************/
+#include <ostream>
+#include <string>
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Functions *************************************************************/
+/** @brief Write a string as a quoted JSON string, escaping the characters JSON does not allow as is. */
+void write_json_string(std::ostream& output_stream, const std::string& value);
+
+inline const char *json_bool(bool value)
+{
+    return (true == value)? "true": "false";
+}
+
+}
+
+#endif /* __JSON_H__ */
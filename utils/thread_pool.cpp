@@ -0,0 +1,189 @@
+/**
+ * @brief  Fixed size pool of worker threads, running queued tasks with work stealing.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+/** Headers ***************************************************************/
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "common.h"
+
+#include "utils/thread_pool.h"
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Functions *************************************************************/
+ThreadPool::ThreadPool(std::size_t num_threads):
+    next_queue_index(0),
+    num_queued_tasks(0),
+    num_pending_tasks(0),
+    is_stopping(false)
+{
+    std::size_t thread_index = 0;
+
+    /* hardware_concurrency may not be known, in which case a single thread is used. */
+    if (0 == num_threads) {
+        num_threads = MAX(std::thread::hardware_concurrency(), 1U);
+    }
+
+    /* Every queue exists before any worker starts, since workers steal from each other's. */
+    for (thread_index = 0; thread_index < num_threads; thread_index++) {
+        this->queues.push_back(new struct WorkerQueue);
+    }
+
+    for (thread_index = 0; thread_index < num_threads; thread_index++) {
+        this->threads.emplace_back(&ThreadPool::run_worker, this, thread_index);
+    }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+        this->is_stopping = true;
+    }
+
+    this->task_available.notify_all();
+
+    for (std::thread& thread : this->threads) {
+        thread.join();
+    }
+
+    for (struct WorkerQueue *queue : this->queues) {
+        delete queue;
+    }
+
+    this->queues.clear();
+}
+
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    this->submit_resumable([task]() {
+        task();
+        return true;
+    });
+}
+
+
+void ThreadPool::submit_resumable(std::function<bool()> task)
+{
+    struct WorkerQueue *queue = nullptr;
+
+    /* The task is counted before it is queued, so that a worker never takes a task it has not seen counted. */
+    {
+        std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+        queue = this->queues[this->next_queue_index];
+        this->next_queue_index = (this->next_queue_index + 1) % this->queues.size();
+        this->num_queued_tasks++;
+        this->num_pending_tasks++;
+    }
+
+    {
+        std::unique_lock<std::mutex> queue_lock(queue->queue_mutex);
+        queue->tasks.push_back({std::move(task), false});
+    }
+
+    this->task_available.notify_one();
+}
+
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+
+    this->tasks_finished.wait(tasks_lock, [this]() {
+        return 0 == this->num_pending_tasks;
+    });
+}
+
+
+void ThreadPool::run_worker(std::size_t worker_index)
+{
+    struct WorkerTask task;
+    struct WorkerQueue *own_queue = this->queues[worker_index];
+    bool is_finished = false;
+
+    while (true) {
+        if (false == this->take_task(worker_index, &task)) {
+            std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+
+            this->task_available.wait(tasks_lock, [this]() {
+                return (true == this->is_stopping) || (0 < this->num_queued_tasks);
+            });
+
+            /* The queues are drained before stopping, so that no submitted task is dropped. */
+            if (0 == this->num_queued_tasks) {
+                break;
+            }
+
+            continue;
+        }
+
+        /* The task is run without holding any lock, so that the other workers can proceed. */
+        is_finished = task.function();
+        if (false == is_finished) {
+            std::unique_lock<std::mutex> queue_lock(own_queue->queue_mutex);
+            own_queue->tasks.push_front(std::move(task));
+            continue;
+        }
+
+        task.function = nullptr;
+
+        {
+            std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+            this->num_pending_tasks--;
+            if (0 == this->num_pending_tasks) {
+                this->tasks_finished.notify_all();
+            }
+        }
+    }
+}
+
+
+bool ThreadPool::take_task(std::size_t worker_index, struct ThreadPool::WorkerTask *output_task)
+{
+    std::size_t queue_offset = 0;
+    struct WorkerQueue *queue = nullptr;
+
+    ASSERT(nullptr != output_task);
+
+    /* Thieves take from the back, away from the front, where the owner resumes its yielded task. */
+    for (queue_offset = 0; queue_offset < this->queues.size(); queue_offset++) {
+        queue = this->queues[(worker_index + queue_offset) % this->queues.size()];
+
+        std::unique_lock<std::mutex> queue_lock(queue->queue_mutex);
+        if (true == queue->tasks.empty()) {
+            continue;
+        }
+
+        if (0 == queue_offset) {
+            *output_task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        } else {
+            *output_task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+
+        queue_lock.unlock();
+
+        if (false == output_task->is_started) {
+            std::unique_lock<std::mutex> tasks_lock(this->tasks_mutex);
+            this->num_queued_tasks--;
+            output_task->is_started = true;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -0,0 +1,100 @@
+/**
+ * @brief  Fixed size pool of worker threads, running queued tasks with work stealing.
+ * @author agent
+ * @date   19/10/2026
+ * */
+
+#ifndef __THREAD_POOL_H__
+#define __THREAD_POOL_H__
+
+/** Headers ***************************************************************/
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** Namespaces ************************************************************/
+namespace utils {
+
+/** Classes ***************************************************************/
+/** @brief Every worker has a queue of its own, which submitted tasks are spread over.
+ *         A worker takes the tasks of its own queue from the front, and once it runs out,
+ *         it steals from the back of the others', so that no worker idles while tasks are pending anywhere.
+ * */
+class ThreadPool {
+public:
+    /** @brief          Start the worker threads.
+     *
+     *  @param[in]      num_threads                 The number of worker threads,
+     *                                              or 0 for the number of hardware threads.
+     * */
+    explicit ThreadPool(std::size_t num_threads = 0);
+
+    /** @brief Wait for the queued tasks to finish, and stop the worker threads. */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @brief          Queue a task to be run by one of the worker threads. */
+    void submit(std::function<void()> task);
+
+    /** @brief          Queue a task that runs in slices, such as an emulation that yields at frame boundaries.
+     *                  The task is called for a slice at a time, until it returns true once it has finished.
+     *                  A task that yields goes back to the front of its worker's queue, and so the worker resumes
+     *                  it before starting anything else, unless an idle worker steals it in between.
+     * */
+    void submit_resumable(std::function<bool()> task);
+
+    /** @brief          Block until every task submitted so far has finished running. */
+    void wait();
+
+    inline std::size_t get_num_threads() const
+    {
+        return this->threads.size();
+    }
+
+private:
+    struct WorkerTask {
+        std::function<bool()> function;
+        bool is_started;
+    };
+
+    struct WorkerQueue {
+        std::mutex queue_mutex;
+        std::deque<struct WorkerTask> tasks;
+    };
+
+    void run_worker(std::size_t worker_index);
+
+    /** @brief          Take the next task of a worker, from its own queue or else stolen from another worker's.
+     *
+     *  @param[in]      worker_index                The index of the worker.
+     *  @param[out]     output_task                 The task taken.
+     *
+     *  @return         Whether a task was taken.
+     * */
+    bool take_task(std::size_t worker_index, struct WorkerTask *output_task);
+
+    std::vector<std::thread> threads;
+    std::vector<struct WorkerQueue *> queues;
+    /* The queue the next submitted task goes to. */
+    std::size_t next_queue_index;
+    std::mutex tasks_mutex;
+    std::condition_variable task_available;
+    std::condition_variable tasks_finished;
+    /* Tasks that are queued and have not started yet, which idle workers wake up to steal.
+     * Yielded tasks are left out, since their own worker resumes them right away.
+     * */
+    std::size_t num_queued_tasks;
+    /* Tasks that are either queued or running. */
+    std::size_t num_pending_tasks;
+    bool is_stopping;
+};
+
+}
+
+#endif /* __THREAD_POOL_H__ */
@@ -8,7 +8,11 @@
 #define __UTILS_H__
 
 /** Headers ***************************************************************/
+#include <cctype>
+#include <cerrno>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -51,9 +55,23 @@ public:
     {
         return new SubClass();
     }
+
+    /** @brief Retrieve the process-wide instance of a stateless subclass, shared by every caller and never deleted.
+     *         The instance is constructed on first use, which is thread safe.
+     * */
+    template<class SubClass>
+    static inline BaseClass *get_shared_instance()
+    {
+        static SubClass shared_instance;
+
+        return &shared_instance;
+    }
 };
 
 
+/** @brief A list of instance functions indexed by type, each returning the shared instance of its type.
+ *         See SubClassFactory::get_shared_instance.
+ * */
 template<typename TypeIndex, class BaseClass>
 class InstanceFactoryList {
 public:
@@ -61,34 +79,34 @@ public:
         instance_functions(instance_function_list)
     {};
 
-    inline enum PeNESStatus create_instance(
+    inline enum PeNESStatus get_instance(
         TypeIndex instance_type_index,
         BaseClass **output_instance
     ) const
     {
         enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
         BaseClass *(*instance_function)() = nullptr;
-        BaseClass *new_instance = nullptr;
+        BaseClass *instance = nullptr;
 
         ASSERT(nullptr != output_instance);
 
         /* Check if the parameter type index is within the bounds of the vector. */
         if ((this->instance_functions.size() <= instance_type_index) ||
             (0 > instance_type_index)) {
-            status = PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_CREATE_INSTANCE_OUT_OF_BOUNDS;
+            status = PENES_STATUS_UTILS_INSTANCE_FACTORY_LIST_GET_INSTANCE_OUT_OF_BOUNDS;
             DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("Type index out of bounds. Status: %d", status);
             goto l_cleanup;
         }
 
-        /* Retrieve the object instance function and initialize it.
+        /* Retrieve the object instance function and call it.
          * If the instance function is null, return null.
          * */
         instance_function = this->instance_functions.at(instance_type_index);
         if (nullptr != instance_function) {
-            new_instance = instance_function();
+            instance = instance_function();
         }
 
-        *output_instance = new_instance;
+        *output_instance = instance;
 
         status = PENES_STATUS_SUCCESS;
     l_cleanup:
@@ -100,6 +118,10 @@ private:
 };
 
 
+/** @brief A table of objects indexed by encoding, along with a lookup by type.
+ *         The objects are the shared instances of their types, and so the table does not own them,
+ *         and any number of tables and emulator instances refer to the same objects.
+ * */
 template<typename TypeIndex, class BaseClass>
 class ObjectTable {
 public:
@@ -109,33 +131,23 @@ public:
     ): instance_factory_list(instance_factory_list)
     {
         enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
-        BaseClass *new_object = nullptr;
+        BaseClass *shared_object = nullptr;
 
         ASSERT(nullptr != instance_factory_list);
 
         /* Iterate through the argument type list.
-         * For each type, find the corresponding instance factory method and create an instance.
-         * Insert the new instance into a table.
+         * For each type, find the corresponding instance function and retrieve its shared instance.
+         * Insert the instance into a table.
          * Additionally, insert the instance and corresponding type into a map for lookup by type.
          * */
         for (TypeIndex type_index : type_list) {
 
-            status = this->instance_factory_list->create_instance(type_index, &new_object);
+            status = this->instance_factory_list->get_instance(type_index, &shared_object);
             ASSERT(PENES_STATUS_SUCCESS == status);
 
-            this->instance_table.push_back(std::make_pair(type_index, new_object));
-            this->type_lookup_map.insert({type_index, new_object});
-        }
-    }
-
-    ~ObjectTable()
-    {
-        /* Iterate through the object vector table and delete each instance. */
-        for (std::pair<TypeIndex, BaseClass *> object_pair : this->instance_table) {
-            delete object_pair.second;
+            this->instance_table.push_back(std::make_pair(type_index, shared_object));
+            this->type_lookup_map.insert({type_index, shared_object});
         }
-
-        this->instance_table.clear();
     }
 
     enum PeNESStatus get_type(
@@ -189,7 +201,7 @@ public:
     enum PeNESStatus get_object_by_type(
         TypeIndex type_index,
         BaseClass **output_object
-    )
+    ) const
     {
         enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
         typename std::unordered_map<TypeIndex, BaseClass *>::const_iterator instance_iter;
@@ -198,17 +210,16 @@ public:
         ASSERT(nullptr != output_object);
 
         /* Check if the type exists in the map.
-         * If it doesn't, create a new instance of said type and insert it into the map.
+         * If it doesn't, retrieve the shared instance of said type, which is as cheap as the lookup itself.
+         * The map is left as is, so that a table can be shared between threads.
          * */
         instance_iter = this->type_lookup_map.find(type_index);
         if (this->type_lookup_map.end() == instance_iter) {
-            status = this->instance_factory_list->create_instance(type_index, &found_object);
+            status = this->instance_factory_list->get_instance(type_index, &found_object);
             if (PENES_STATUS_SUCCESS != status) {
-                DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("create_instance failed. Status: %d\n", status);
+                DEBUG_PRINT_WITH_ERRNO_WITH_ARGS("get_instance failed. Status: %d\n", status);
                 goto l_cleanup;
             }
-
-            this->type_lookup_map.insert({type_index, found_object});
         } else {
             /* Retrieve the object instance from the map. */
             found_object = instance_iter->second;
@@ -232,6 +243,46 @@ private:
     std::unordered_map<TypeIndex, BaseClass *> type_lookup_map;
 };
 
+/** Functions *************************************************************/
+/** @brief          Parse a decimal size, such as a count given on the command line.
+ *                  Unlike strtoul alone, the text must be made of digits only, so that a sign, a leading space
+ *                  or anything trailing the digits is rejected rather than wrapped or ignored.
+ *
+ *  @param[in]      size_text                   The text to parse.
+ *  @param[out]     output_size                 The parsed size.
+ *
+ *  @return         Status indicating the success of the operation.
+ * */
+inline enum PeNESStatus parse_size(const char *size_text, std::size_t *output_size)
+{
+    enum PeNESStatus status = PENES_STATUS_UNINITIALIZED;
+    char *size_text_end = nullptr;
+    unsigned long long size = 0;
+
+    ASSERT(nullptr != size_text);
+    ASSERT(nullptr != output_size);
+
+    if (0 == isdigit(static_cast<unsigned char>(size_text[0]))) {
+        status = PENES_STATUS_UTILS_PARSE_SIZE_INVALID;
+        DEBUG_PRINT_WITH_ARGS("The size does not start with a digit. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    errno = 0;
+    size = strtoull(size_text, &size_text_end, DECIMAL_BASE);
+    if ((0 != errno) || ('\0' != *size_text_end) || (SIZE_MAX < size)) {
+        status = PENES_STATUS_UTILS_PARSE_SIZE_INVALID;
+        DEBUG_PRINT_WITH_ARGS("The size is not a number, or is out of range. Status: %d\n", status);
+        goto l_cleanup;
+    }
+
+    *output_size = static_cast<std::size_t>(size);
+
+    status = PENES_STATUS_SUCCESS;
+l_cleanup:
+    return status;
+}
+
 }
 
 #endif /* __UTILS_H__ */